@@ -0,0 +1,87 @@
+#ifndef VECTOR_BENCH_H
+#define VECTOR_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Minimal benchmark harness: benchmarks register themselves with
+// VECTOR_BENCHMARK and vector_bench runs those whose names match its arguments.
+//
+//     vector_bench                      // everything, at the sizes the requests name
+//     vector_bench --quick sort simd    // benchmarks containing "sort" or "simd", sizes / 100
+//
+// Build with optimizations (-DCMAKE_BUILD_TYPE=Release); times are the best of several runs.
+
+namespace bench {
+
+struct Options {
+    bool quick = false;
+
+    // Problem size: full as given, divided by 100 (at least minimum) with --quick.
+    size_t scaled(size_t full, size_t minimum = 1) const {
+        return quick ? std::max(full / 100, minimum) : full;
+    }
+};
+
+using Function = void (*)(const Options&);
+
+struct Benchmark {
+    const char* name;
+    Function function;
+};
+
+inline std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registration {
+    Registration(const char* name, Function function) {
+        registry().push_back(Benchmark{name, function});
+    }
+};
+
+#define VECTOR_BENCHMARK(name) \
+    static void name(const bench::Options& ); \
+    static bench::Registration name##_registration(#name, name); \
+    static void name(const bench::Options& options)
+
+// Keeps the compiler from discarding a computed value.
+template <class T>
+inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Best wall time of repeats runs of run(), in milliseconds.
+template <class Run>
+double best_ms(size_t repeats, Run run) {
+    double best = 0;
+    for (size_t i = 0; i < repeats; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// One result line: benchmark, case, time and a free-form rate or comparison.
+inline void report(const std::string& benchmark, const std::string& label, double ms, const std::string& note = "") {
+    std::printf("%-24s %-44s %12.3f ms  %s\n", benchmark.c_str(), label.c_str(), ms, note.c_str());
+    std::fflush(stdout);
+}
+
+inline std::string format(const char* pattern, double value) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), pattern, value);
+    return buffer;
+}
+
+} // namespace bench
+
+
+#endif //VECTOR_BENCH_H
@@ -0,0 +1,98 @@
+#include "bench.h"
+#include "../Vector.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Growth by push_back/emplace_back on the nothrow-move path, where the
+// exception-safe reallocation must cost nothing. Vector is compared with
+// std::vector and with UnguardedGrowth, the reallocation loop Vector used
+// before it guarded against throwing elements.
+
+namespace {
+
+template <class T>
+class UnguardedGrowth {
+public:
+    ~UnguardedGrowth() {
+        for (size_t i = 0; i < size_; ++i) {
+            traits::destroy(alloc_, arr_ + i);
+        }
+        if (arr_ != nullptr) {
+            traits::deallocate(alloc_, arr_, capacity_);
+        }
+    }
+
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            const size_t new_capacity = capacity_ == 0 ? 1 : 2 * capacity_;
+            T* new_arr = traits::allocate(alloc_, new_capacity);
+            traits::construct(alloc_, new_arr + size_, std::forward<Args>(args)...);
+            for (size_t i = 0; i < size_; ++i) {
+                traits::construct(alloc_, new_arr + i, std::move_if_noexcept(arr_[i]));
+                traits::destroy(alloc_, arr_ + i);
+            }
+            if (arr_ != nullptr) {
+                traits::deallocate(alloc_, arr_, capacity_);
+            }
+            arr_ = new_arr;
+            capacity_ = new_capacity;
+        } else {
+            traits::construct(alloc_, arr_ + size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+private:
+    using traits = std::allocator_traits<std::allocator<T>>;
+
+    std::allocator<T> alloc_;
+    T* arr_ = nullptr;
+    size_t size_ = 0, capacity_ = 0;
+};
+
+template <class Container, class Make>
+double time_growth(size_t rounds, size_t size, Make make) {
+    return bench::best_ms(1, [&] {
+        for (size_t round = 0; round < rounds; ++round) {
+            Container values;
+            for (size_t i = 0; i < size; ++i) {
+                values.emplace_back(make(i));
+            }
+            bench::keep(values.size());
+        }
+    });
+}
+
+// The three containers take turns, so none of them always runs on a heap
+// left in the same state by the one before; every result is the best pass.
+template <class T, class Make>
+void run_growth(const char* type, size_t rounds, size_t size, Make make) {
+    double unguarded_ms = 0, vector_ms = 0, std_ms = 0;
+    for (int pass = 0; pass < 5; ++pass) {
+        const double unguarded = time_growth<UnguardedGrowth<T>>(rounds, size, make);
+        const double vector = time_growth<Vector<T>>(rounds, size, make);
+        const double standard = time_growth<std::vector<T>>(rounds, size, make);
+        unguarded_ms = pass == 0 ? unguarded : std::min(unguarded_ms, unguarded);
+        vector_ms = pass == 0 ? vector : std::min(vector_ms, vector);
+        std_ms = pass == 0 ? standard : std::min(std_ms, standard);
+    }
+    const std::string label = std::string(type) + " " + std::to_string(rounds) + "x" + std::to_string(size);
+    bench::report("growth", label + " unguarded reference", unguarded_ms);
+    bench::report("growth", label + " Vector", vector_ms, bench::format("x%.2f vs unguarded", unguarded_ms / vector_ms));
+    bench::report("growth", label + " std::vector", std_ms, bench::format("x%.2f vs unguarded", unguarded_ms / std_ms));
+}
+
+} // namespace
+
+VECTOR_BENCHMARK(growth_nothrow) {
+    run_growth<long>("long", options.scaled(50, 1), 1000000, [](size_t i) { return static_cast<long>(i); });
+    run_growth<std::string>("string", options.scaled(5, 1), 300000,
+                            [](size_t i) { return std::string(24, static_cast<char>('a' + i % 26)); });
+}
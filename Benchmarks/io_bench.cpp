@@ -0,0 +1,101 @@
+#include "bench.h"
+#include "../VectorIO.h"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Reading a 2 GiB file of uint64_t into a Vector: append_from_fd and
+// append_from_istream against reading into a buffer and pushing every element.
+// The file is created in $TMPDIR (or /tmp) and read once before timing, so the
+// runs measure the copy out of the page cache rather than the disk.
+
+namespace {
+
+class TemporaryFile {
+public:
+    explicit TemporaryFile(size_t bytes) {
+        const char* directory = std::getenv("TMPDIR");
+        path_ = std::string(directory != nullptr ? directory : "/tmp") + "/vector_bench_XXXXXX";
+        const int fd = mkstemp(&path_[0]);
+        if (fd < 0) {
+            throw std::runtime_error("cannot create " + path_);
+        }
+
+        Vector<uint64_t> chunk((1 << 20) / sizeof(uint64_t));
+        uint64_t value = 0;
+        for (size_t written = 0; written < bytes; written += chunk.size() * sizeof(uint64_t)) {
+            for (size_t i = 0; i < chunk.size(); ++i) {
+                chunk[i] = value++;
+            }
+            if (write(fd, chunk.data(), chunk.size() * sizeof(uint64_t)) < 0) {
+                close(fd);
+                throw std::runtime_error("cannot write " + path_);
+            }
+        }
+        close(fd);
+    }
+    ~TemporaryFile() {
+        unlink(path_.c_str());
+    }
+
+    const std::string& path() const {
+        return path_;
+    }
+
+private:
+    std::string path_;
+};
+
+int open_file(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    return fd;
+}
+
+} // namespace
+
+VECTOR_BENCHMARK(io_ingest) {
+    const size_t bytes = options.scaled(size_t(2) << 30, size_t(1) << 20);
+    TemporaryFile file(bytes);
+
+    auto measure = [&](const std::string& variant, size_t (*read_file)(const std::string& )) {
+        read_file(file.path());
+        const double ms = bench::best_ms(3, [&] { bench::keep(read_file(file.path())); });
+        bench::report("io", std::to_string(bytes >> 20) + " MiB " + variant, ms,
+                      bench::format("%.2f GB/s", bytes / ms / 1e6));
+    };
+
+    measure("read + push_back loop", [](const std::string& path) -> size_t {
+        const int fd = open_file(path);
+        Vector<uint64_t> values;
+        uint64_t buffer[(64 << 10) / sizeof(uint64_t)];
+        ssize_t count;
+        while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (size_t i = 0; i < static_cast<size_t>(count) / sizeof(uint64_t); ++i) {
+                values.push_back(buffer[i]);
+            }
+        }
+        close(fd);
+        return values.size();
+    });
+    measure("append_from_fd", [](const std::string& path) -> size_t {
+        const int fd = open_file(path);
+        Vector<uint64_t> values;
+        append_from_fd(values, fd);
+        close(fd);
+        return values.size();
+    });
+    measure("append_from_istream", [](const std::string& path) -> size_t {
+        std::ifstream in(path, std::ios::binary);
+        Vector<uint64_t> values;
+        append_from_istream(values, in);
+        return values.size();
+    });
+}
@@ -0,0 +1,36 @@
+#include "bench.h"
+#include <cstring>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+    bench::Options options;
+    std::vector<std::string> filters;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            for (const bench::Benchmark& benchmark: bench::registry()) {
+                std::printf("%s\n", benchmark.name);
+            }
+            return 0;
+        } else {
+            filters.push_back(argv[i]);
+        }
+    }
+
+#if !defined(__OPTIMIZE__)
+    std::printf("warning: built without optimizations, configure with -DCMAKE_BUILD_TYPE=Release\n");
+#endif
+    std::printf("hardware threads: %u%s\n", std::thread::hardware_concurrency(), options.quick ? ", quick sizes" : "");
+
+    for (const bench::Benchmark& benchmark: bench::registry()) {
+        bool selected = filters.empty();
+        for (const std::string& filter: filters) {
+            selected = selected || std::strstr(benchmark.name, filter.c_str()) != nullptr;
+        }
+        if (selected) {
+            benchmark.function(options);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "bench.h"
+#include "../PoolAllocator.h"
+#include <thread>
+
+// Push/pop oscillation on 16 threads: every thread fills a Vector<long> to a
+// varying size and pops it empty again, so doubling and the quarter-full
+// halving keep allocating and freeing buffers of the same sizes. Compares
+// std::allocator with PoolAllocator.
+
+namespace {
+
+template <class Alloc>
+void oscillate(size_t cycles) {
+    Vector<long, Alloc> values;
+    long sum = 0;
+    for (size_t cycle = 0; cycle < cycles; ++cycle) {
+        const size_t size = 64 << (cycle % 10);   // 64 .. 32768 elements
+        for (size_t i = 0; i < size; ++i) {
+            values.push_back(static_cast<long>(i));
+        }
+        while (!values.empty()) {
+            sum += values.back();
+            values.pop_back();
+        }
+    }
+    bench::keep(sum);
+}
+
+template <class Alloc>
+double run_threads(size_t threads, size_t cycles) {
+    return bench::best_ms(3, [&] {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back(oscillate<Alloc>, cycles);
+        }
+        for (std::thread& worker: workers) {
+            worker.join();
+        }
+    });
+}
+
+} // namespace
+
+VECTOR_BENCHMARK(pool_oscillation) {
+    const size_t threads = 16;
+    const size_t cycles = options.scaled(2000, 10);
+    // elements pushed and popped per thread, over the 10 sizes of a round
+    const double operations = 2.0 * threads * (cycles / 10.0) * 64 * 1023;
+
+    const double global_ms = run_threads<std::allocator<long>>(threads, cycles);
+    bench::report("pool", "16 threads, std::allocator", global_ms,
+                  bench::format("%.1f M push+pop/s", operations / global_ms / 1e3));
+    const double pool_ms = run_threads<PoolAllocator<long>>(threads, cycles);
+    bench::report("pool", "16 threads, PoolAllocator", pool_ms,
+                  bench::format("%.1f M push+pop/s", operations / pool_ms / 1e3) +
+                  bench::format(", x%.2f", global_ms / pool_ms));
+}
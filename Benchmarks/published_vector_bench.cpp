@@ -0,0 +1,103 @@
+#include "bench.h"
+#include "../PublishedVector.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+// Reader scaling of PublishedVector against a Vector behind a reader-writer lock.
+// Readers look up entries of a 1024-entry table while a writer republishes it
+// every millisecond. std::shared_timed_mutex stands in for std::shared_mutex,
+// which needs C++17; libstdc++ implements both over pthread_rwlock_t.
+
+namespace {
+
+const size_t table_size = 1024;
+
+Vector<int> make_table(int version) {
+    return Vector<int>(table_size, version);
+}
+
+// Runs readers threads for duration. Each thread makes its lookup function with
+// make_lookup() and calls it in a loop; returns the total number of lookups.
+template <class MakeLookup, class Publish>
+size_t run_readers(size_t readers, std::chrono::milliseconds duration, MakeLookup make_lookup, Publish publish) {
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> lookups(0);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t] {
+            auto lookup = make_lookup();
+            size_t count = 0;
+            long sum = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                sum += lookup((t * 7919 + count) % table_size);
+                ++count;
+            }
+            bench::keep(sum);
+            lookups += count;
+        });
+    }
+    std::thread writer([&] {
+        for (int version = 1; !stop.load(std::memory_order_relaxed); ++version) {
+            publish(version);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    writer.join();
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+    return lookups.load();
+}
+
+} // namespace
+
+VECTOR_BENCHMARK(published_vector_readers) {
+    const std::chrono::milliseconds duration(options.quick ? 50 : 500);
+    std::vector<size_t> reader_counts = {1, 4, 16, 64, 256};
+    if (options.quick) {
+        reader_counts.resize(3);
+    }
+
+    for (size_t readers: reader_counts) {
+        PublishedVector<int> published(make_table(0));
+        const size_t published_lookups = run_readers(readers, duration,
+            [&] {
+                // registered once per thread, as a long-lived reader would be
+                std::shared_ptr<PublishedVector<int>::Reader> reader(
+                    new PublishedVector<int>::Reader(published.reader()));
+                return [reader](size_t i) { return (*reader->read())[i]; };
+            },
+            [&](int version) { published.publish(make_table(version)); });
+
+        std::shared_timed_mutex mutex;
+        Vector<int> locked = make_table(0);
+        const size_t locked_lookups = run_readers(readers, duration,
+            [&] {
+                return [&](size_t i) {
+                    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+                    return locked[i];
+                };
+            },
+            [&](int version) {
+                Vector<int> next = make_table(version);
+                std::lock_guard<std::shared_timed_mutex> lock(mutex);
+                locked = std::move(next);
+            });
+
+        const double ms = static_cast<double>(duration.count());
+        const std::string threads = std::to_string(readers) + " readers";
+        bench::report("published_vector", threads + ", PublishedVector", ms,
+                      bench::format("%.1f M lookups/s", published_lookups / ms / 1e3));
+        bench::report("published_vector", threads + ", shared_timed_mutex", ms,
+                      bench::format("%.1f M lookups/s", locked_lookups / ms / 1e3) +
+                      bench::format(" (PublishedVector x%.2f)",
+                                    static_cast<double>(published_lookups) / std::max<size_t>(locked_lookups, 1)));
+    }
+}
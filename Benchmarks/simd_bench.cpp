@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "../VectorSimd.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+
+// SIMD kernels against the std algorithms at 1K, 1M and 100M elements, for
+// int and float, at every instruction set the CPU supports. Small inputs are
+// repeated so that every measurement covers about 100M elements.
+
+namespace {
+
+const char* level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        default: return "avx512";
+    }
+}
+
+template <class T>
+Vector<T> make_values(size_t size, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 1000);
+    Vector<T> values;
+    values.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        values.push_back(static_cast<T>(distribution(generator)));
+    }
+    return values;
+}
+
+template <class T>
+void run_kernels(const char* type, size_t size, const bench::Options& options) {
+    const Vector<T> lhs = make_values<T>(size, 1);
+    const Vector<T> rhs = make_values<T>(size, 2);
+    const T* data = lhs.data();
+    const T absent = static_cast<T>(-1);
+    const size_t rounds = std::max<size_t>(1, options.scaled(100000000) / size);
+    const size_t repeats = size >= 100000000 ? 2 : 5;
+
+    auto measure = [&](const std::string& kernel, const std::string& variant, double bytes_per_element,
+                       std::function<void()> kernel_run) {
+        const double ms = bench::best_ms(repeats, [&] {
+            for (size_t round = 0; round < rounds; ++round) {
+                kernel_run();
+            }
+        });
+        const double bytes = bytes_per_element * sizeof(T) * size * rounds;
+        bench::report("simd", std::string(type) + " " + std::to_string(size) + " " + kernel + " " + variant,
+                      ms, bench::format("%.2f GB/s", bytes / ms / 1e6));
+    };
+
+    // std baselines over raw pointers, so they are not held back by the iterator type
+    measure("find", "std", 1, [&] { bench::keep(std::find(data, data + size, absent)); });
+    measure("count", "std", 1, [&] { bench::keep(std::count(data, data + size, absent)); });
+    measure("minmax", "std", 1, [&] { bench::keep(std::minmax_element(data, data + size)); });
+    measure("sum", "std", 1, [&] { bench::keep(std::accumulate(data, data + size, T())); });
+    measure("dot", "std", 2, [&] { bench::keep(std::inner_product(data, data + size, rhs.data(), T())); });
+
+    const SimdLevel supported = simd::supported_level();
+    for (int level = 0; level <= static_cast<int>(supported); ++level) {
+        simd::set_level(static_cast<SimdLevel>(level));
+        const char* name = level_name(static_cast<SimdLevel>(level));
+        measure("find", name, 1, [&] { bench::keep(simd::find(lhs, absent)); });
+        measure("count", name, 1, [&] { bench::keep(simd::count(lhs, absent)); });
+        measure("minmax", name, 1, [&] { bench::keep(simd::minmax(lhs)); });
+        measure("sum", name, 1, [&] { bench::keep(simd::sum(lhs)); });
+        measure("dot", name, 2, [&] { bench::keep(simd::dot(lhs, rhs)); });
+    }
+    simd::set_level(supported);
+}
+
+} // namespace
+
+VECTOR_BENCHMARK(simd_kernels) {
+    for (size_t size: {size_t(1000), size_t(1000000), size_t(100000000)}) {
+        const size_t scaled = size >= 100000000 ? options.scaled(size) : size;
+        run_kernels<int>("int", scaled, options);
+        run_kernels<float>("float", scaled, options);
+    }
+}
@@ -0,0 +1,100 @@
+#include "bench.h"
+#include "../VectorSort.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+
+// Vector sorts against std::sort and std::stable_sort at 1M and 100M elements.
+// Every run sorts freshly generated random data; generation is not timed.
+
+namespace {
+
+struct Record {
+    uint64_t key;
+    uint32_t payload;
+};
+
+template <class T>
+T random_value(std::mt19937_64& generator) {
+    return static_cast<T>(generator());
+}
+
+template <>
+float random_value<float>(std::mt19937_64& generator) {
+    return std::uniform_real_distribution<float>(-1e6f, 1e6f)(generator);
+}
+
+template <>
+Record random_value<Record>(std::mt19937_64& generator) {
+    return Record{generator(), static_cast<uint32_t>(generator())};
+}
+
+// Best time of sorting fresh data with sort_values(values).
+template <class T, class Sort>
+double time_sort(size_t size, size_t repeats, Sort sort_values) {
+    Vector<T> values(size);
+    double best = 0;
+    for (size_t i = 0; i < repeats; ++i) {
+        std::mt19937_64 generator(i);
+        for (size_t j = 0; j < size; ++j) {
+            values[j] = random_value<T>(generator);
+        }
+        const double ms = bench::best_ms(1, [&] { sort_values(values); });
+        best = i == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+template <class T, class Sort>
+void report_sort(const char* type, size_t size, size_t repeats, const std::string& variant,
+                 double std_ms, Sort sort_values) {
+    const double ms = time_sort<T>(size, repeats, sort_values);
+    bench::report("sort", std::string(type) + " " + std::to_string(size) + " " + variant, ms,
+                  bench::format("%.1f M elements/s", size / ms / 1e3) +
+                  (std_ms > 0 ? bench::format(", x%.2f vs std", std_ms / ms) : ""));
+}
+
+template <class T>
+void run_sorts(const char* type, size_t size, size_t repeats) {
+    const double std_ms = time_sort<T>(size, repeats, [](Vector<T>& values) {
+        std::sort(values.data(), values.data() + values.size());
+    });
+    bench::report("sort", std::string(type) + " " + std::to_string(size) + " std::sort", std_ms,
+                  bench::format("%.1f M elements/s", size / std_ms / 1e3));
+    report_sort<T>(type, size, repeats, "sorting::sort (radix)", std_ms,
+                   [](Vector<T>& values) { sorting::sort(values); });
+    report_sort<T>(type, size, repeats, "sorting::sort (merge)", std_ms,
+                   [](Vector<T>& values) { sorting::sort(values, std::less<T>()); });
+}
+
+} // namespace
+
+VECTOR_BENCHMARK(sort_keys) {
+    for (size_t full: {size_t(1000000), size_t(100000000)}) {
+        const size_t size = full >= 100000000 ? options.scaled(full) : full;
+        const size_t repeats = size >= 100000000 ? 1 : 3;
+        run_sorts<uint32_t>("uint32", size, repeats);
+        run_sorts<uint64_t>("uint64", size, repeats);
+        run_sorts<float>("float", size, repeats);
+    }
+}
+
+// Stable sorts of records by key: radix sort with a key extractor, parallel
+// stable merge sort, and std::stable_sort.
+VECTOR_BENCHMARK(sort_records) {
+    const size_t size = options.scaled(10000000);
+    auto by_key = [](const Record& lhs, const Record& rhs) { return lhs.key < rhs.key; };
+
+    const double std_ms = time_sort<Record>(size, 3, [&](Vector<Record>& values) {
+        std::stable_sort(values.data(), values.data() + values.size(), by_key);
+    });
+    bench::report("sort", "record " + std::to_string(size) + " std::stable_sort", std_ms,
+                  bench::format("%.1f M elements/s", size / std_ms / 1e3));
+    report_sort<Record>("record", size, 3, "sorting::radix_sort by key", std_ms, [](Vector<Record>& values) {
+        sorting::radix_sort(values, [](const Record& record) { return record.key; });
+    });
+    report_sort<Record>("record", size, 3, "sorting::stable_sort", std_ms, [&](Vector<Record>& values) {
+        sorting::stable_sort(values, by_key);
+    });
+}
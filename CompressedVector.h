@@ -0,0 +1,338 @@
+#ifndef COMPRESSED_VECTOR_H
+#define COMPRESSED_VECTOR_H
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Vector.h"
+
+// Append-only sequence of integers stored in compressed blocks.
+// Every block_size values are sealed into a block: a small header and the
+// values bit-packed at the narrowest width that fits the block. A block is
+// coded either as frame of reference (value - block minimum) or, when the
+// block is non-decreasing, as deltas to the value four positions earlier,
+// whichever is narrower. Values not yet filling a block stay uncompressed.
+//
+// Packed words interleave four lanes: value i of a block lives in lane i % 4,
+// so one 4-lane load decodes four consecutive values with one shift.
+//
+// operator[] seeks its block in O(1); inside a frame-of-reference block the
+// value is extracted directly, inside a delta block up to block_size / 4
+// deltas of its lane are summed. Sequential access should go through
+// for_each() or decode_block(), which decode whole blocks.
+template <class Int>
+class CompressedVector {
+public:
+    static const size_t block_size = 256;
+
+    CompressedVector() = default;
+    template <class Alloc>
+    explicit CompressedVector(const Vector<Int, Alloc>& );
+
+    void push_back(Int );
+    void clear();
+
+    Int operator[](size_t ) const;
+    Int at(size_t ) const;
+
+    bool empty() const noexcept;
+    size_t size() const noexcept;
+    size_t blocks() const noexcept;
+    size_t memory_usage() const noexcept;
+
+    // Writes the block_size values of a sealed block to out.
+    void decode_block(size_t , Int* out) const;
+    template <class Function>
+    void for_each(Function function) const;
+    Vector<Int> to_vector() const;
+
+private:
+    static_assert(std::is_integral<Int>::value && !std::is_same<Int, bool>::value &&
+                  sizeof(Int) <= sizeof(uint64_t), "CompressedVector stores integers of up to 64 bits");
+
+    using Unsigned = typename std::make_unsigned<Int>::type;
+    typedef uint64_t Lanes __attribute__((vector_size(4 * sizeof(uint64_t))));
+
+    static const size_t lanes = 4;
+    static const size_t lane_length = block_size / lanes;
+
+    struct BlockHeader {
+        uint64_t base;
+        uint64_t offset;   // of the block's first word in packed_
+        uint8_t width;     // bits per value, each lane takes width words
+        bool delta;
+    };
+
+    static unsigned bit_width(uint64_t ) noexcept;
+    static uint64_t low_bits(unsigned width) noexcept;
+    static uint64_t code(Int value, Int base) noexcept;
+    static Int value(uint64_t code) noexcept;
+    static void load(Lanes& , const uint64_t* words) noexcept;
+
+    void seal(const Int* values);
+    uint64_t extract(const BlockHeader& , size_t lane, size_t position) const noexcept;
+    template <bool delta>
+    void decode_lanes(const BlockHeader& , Int* out) const noexcept;
+
+    Vector<BlockHeader> blocks_;
+    Vector<uint64_t> packed_;
+    Vector<Int> tail_;
+    size_t tail_size_ = 0;
+};
+
+
+//////////////////////////////////////////
+//////////////////////////////////////////
+
+
+template<class Int>
+const size_t CompressedVector<Int>::block_size;
+
+template<class Int>
+template<class Alloc>
+CompressedVector<Int>::CompressedVector(const Vector<Int, Alloc>& values) {
+    const size_t full_blocks = values.size() / block_size;
+    blocks_.reserve(full_blocks);
+    for (size_t block = 0; block < full_blocks; ++block) {
+        seal(values.data() + block * block_size);
+    }
+    packed_.shrink_to_fit();
+
+    for (size_t i = full_blocks * block_size; i < values.size(); ++i) {
+        this->push_back(values[i]);
+    }
+}
+
+template<class Int>
+void CompressedVector<Int>::push_back(Int value) {
+    if (tail_.empty()) {
+        tail_.resize(block_size);
+    }
+    tail_[tail_size_++] = value;
+    if (tail_size_ == block_size) {
+        seal(tail_.data());
+        tail_size_ = 0;
+    }
+}
+
+template<class Int>
+void CompressedVector<Int>::clear() {
+    blocks_.clear();
+    packed_.clear();
+    tail_.clear();
+    tail_size_ = 0;
+}
+
+template<class Int>
+Int CompressedVector<Int>::operator[](size_t ind) const {
+    const size_t block = ind / block_size;
+    if (block == blocks_.size()) {
+        return tail_[ind % block_size];
+    }
+
+    const BlockHeader& header = blocks_[block];
+    const size_t lane = ind % lanes;
+    const size_t position = ind % block_size / lanes;
+    if (!header.delta) {
+        return value(header.base + extract(header, lane, position));
+    }
+    uint64_t sum = header.base;
+    for (size_t i = 0; i <= position; ++i) {
+        sum += extract(header, lane, i);
+    }
+    return value(sum);
+}
+
+template<class Int>
+Int CompressedVector<Int>::at(size_t ind) const {
+    if (ind >= this->size()) {
+        throw std::out_of_range("Accessing a nonexistent array element");
+    }
+    return (*this)[ind];
+}
+
+template<class Int>
+bool CompressedVector<Int>::empty() const noexcept {
+    return this->size() == 0;
+}
+
+template<class Int>
+size_t CompressedVector<Int>::size() const noexcept {
+    return blocks_.size() * block_size + tail_size_;
+}
+
+template<class Int>
+size_t CompressedVector<Int>::blocks() const noexcept {
+    return blocks_.size();
+}
+
+template<class Int>
+size_t CompressedVector<Int>::memory_usage() const noexcept {
+    return sizeof(*this) + blocks_.capacity() * sizeof(BlockHeader) +
+           packed_.capacity() * sizeof(uint64_t) + tail_.capacity() * sizeof(Int);
+}
+
+template<class Int>
+void CompressedVector<Int>::decode_block(size_t block, Int* out) const {
+    const BlockHeader& header = blocks_.at(block);
+    if (header.delta) {
+        decode_lanes<true>(header, out);
+    } else {
+        decode_lanes<false>(header, out);
+    }
+}
+
+template<class Int>
+template<class Function>
+void CompressedVector<Int>::for_each(Function function) const {
+    Int buffer[block_size];
+    for (size_t block = 0; block < blocks_.size(); ++block) {
+        this->decode_block(block, buffer);
+        for (size_t i = 0; i < block_size; ++i) {
+            function(buffer[i]);
+        }
+    }
+    for (size_t i = 0; i < tail_size_; ++i) {
+        function(tail_[i]);
+    }
+}
+
+template<class Int>
+Vector<Int> CompressedVector<Int>::to_vector() const {
+    Vector<Int> result;
+    result.resize(this->size());
+    for (size_t block = 0; block < blocks_.size(); ++block) {
+        this->decode_block(block, result.data() + block * block_size);
+    }
+    for (size_t i = 0; i < tail_size_; ++i) {
+        result[blocks_.size() * block_size + i] = tail_[i];
+    }
+    return result;
+}
+
+
+template<class Int>
+unsigned CompressedVector<Int>::bit_width(uint64_t bits) noexcept {
+    return bits == 0 ? 0 : 64 - __builtin_clzll(bits);
+}
+
+template<class Int>
+uint64_t CompressedVector<Int>::low_bits(unsigned width) noexcept {
+    return width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+}
+
+// Codes are differences taken in the unsigned type, so they wrap the same way for signed Int.
+template<class Int>
+uint64_t CompressedVector<Int>::code(Int value, Int base) noexcept {
+    return static_cast<Unsigned>(static_cast<Unsigned>(value) - static_cast<Unsigned>(base));
+}
+
+template<class Int>
+Int CompressedVector<Int>::value(uint64_t code) noexcept {
+    return static_cast<Int>(static_cast<Unsigned>(code));
+}
+
+// Lanes are never returned by value: without AVX that changes the calling convention.
+template<class Int>
+void CompressedVector<Int>::load(Lanes& result, const uint64_t* words) noexcept {
+    std::memcpy(&result, words, sizeof(result));
+}
+
+template<class Int>
+void CompressedVector<Int>::seal(const Int* values) {
+    Int low = values[0];
+    bool sorted = true;
+    for (size_t i = 1; i < block_size; ++i) {
+        low = values[i] < low ? values[i] : low;
+        sorted = sorted && !(values[i] < values[i - 1]);
+    }
+
+    // The width is that of the largest code, so OR-ing the codes is enough.
+    uint64_t reference_bits = 0, delta_bits = 0;
+    for (size_t i = 0; i < block_size; ++i) {
+        reference_bits |= code(values[i], low);
+        if (sorted) {
+            delta_bits |= code(values[i], values[i < lanes ? 0 : i - lanes]);
+        }
+    }
+    const bool delta = sorted && bit_width(delta_bits) < bit_width(reference_bits);
+    const unsigned width = bit_width(delta ? delta_bits : reference_bits);
+
+    const size_t offset = packed_.size();
+    const size_t required = offset + lanes * width;
+    if (required > packed_.capacity()) {
+        packed_.reserve(required > 2 * packed_.capacity() ? required : 2 * packed_.capacity());
+    }
+    packed_.resize(required, 0);
+
+    uint64_t* words = packed_.data() + offset;
+    for (size_t i = 0; i < block_size && width != 0; ++i) {
+        const uint64_t bits = delta ? code(values[i], values[i < lanes ? 0 : i - lanes]) : code(values[i], low);
+        const size_t bit = i / lanes * width;
+        const size_t shift = bit % 64;
+        uint64_t* word = words + bit / 64 * lanes + i % lanes;
+        word[0] |= bits << shift;
+        if (shift + width > 64) {
+            word[lanes] |= bits >> (64 - shift);
+        }
+    }
+
+    blocks_.push_back(BlockHeader{code(low, 0), offset, static_cast<uint8_t>(width), delta});
+}
+
+template<class Int>
+uint64_t CompressedVector<Int>::extract(const BlockHeader& header, size_t lane, size_t position) const noexcept {
+    if (header.width == 0) {
+        return 0;
+    }
+    const uint64_t* words = packed_.data() + header.offset;
+    const size_t bit = position * header.width;
+    const size_t shift = bit % 64;
+    const uint64_t* word = words + bit / 64 * lanes + lane;
+
+    uint64_t bits = word[0] >> shift;
+    if (shift + header.width > 64) {
+        bits |= word[lanes] << (64 - shift);
+    }
+    return bits & low_bits(header.width);
+}
+
+template<class Int>
+template<bool delta>
+void CompressedVector<Int>::decode_lanes(const BlockHeader& header, Int* out) const noexcept {
+    const unsigned width = header.width;
+    if (width == 0) {
+        for (size_t i = 0; i < block_size; ++i) {
+            out[i] = value(header.base);
+        }
+        return;
+    }
+
+    const uint64_t* words = packed_.data() + header.offset;
+    const uint64_t mask = low_bits(width);
+    Lanes sum = Lanes{} + header.base;
+    for (size_t position = 0; position < lane_length; ++position) {
+        const size_t bit = position * width;
+        const size_t shift = bit % 64;
+        const uint64_t* word = words + bit / 64 * lanes;
+
+        Lanes bits, next;
+        load(bits, word);
+        bits >>= shift;
+        if (shift + width > 64) {
+            load(next, word + lanes);
+            bits |= next << (64 - shift);
+        }
+        bits &= mask;
+
+        Lanes values = delta ? (sum += bits) : bits + header.base;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            out[position * lanes + lane] = value(values[lane]);
+        }
+    }
+}
+
+
+#endif //COMPRESSED_VECTOR_H
@@ -0,0 +1,281 @@
+#ifndef PARALLEL_BUILDER_H
+#define PARALLEL_BUILDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "Vector.h"
+#include "VectorSort.h"
+
+// Collects the output of parallel workers into a single Vector.
+//
+//     ParallelBuilder<Result> builder;
+//     sorting::parallel_for(tasks, threads, [&](size_t task) {
+//         Vector<Result>& shard = builder.local();
+//         ...                                // push_back into shard
+//     });
+//     Vector<Result> results = builder.finish();
+//
+// Every thread appends to its own shard, so workers never contend. finish()
+// sizes the result from the shards, allocates it once and moves the shards
+// into it in parallel, each thread taking whole pieces of the shards.
+// With preserve_order the shards follow each other in the order they were
+// created; otherwise the shard with the largest capacity goes first. In both
+// cases the result takes over the buffer of the first shard when it has room
+// for all elements, and that shard is not moved at all.
+//
+// local() may be called concurrently. Workers must be done with their shards
+// (e.g. joined) before finish(), which leaves the builder empty. Elements
+// whose moves may throw must be copyable: they are copied on the calling
+// thread, and if a copy fails, the shards keep their elements.
+template <class T, class Alloc = std::allocator<T>>
+class ParallelBuilder {
+    static_assert(std::is_nothrow_move_constructible<T>::value || std::is_copy_constructible<T>::value,
+                  "move-only elements whose moves may throw cannot be gathered without losing them");
+
+public:
+    using Shard = Vector<T, Alloc>;
+
+    // threads bounds the threads used by finish(), 0 meaning one per core.
+    explicit ParallelBuilder(size_t threads = 0, const Alloc& = Alloc());
+
+    // Shard of the calling thread, created on its first call.
+    // The lookup takes a lock unless the thread last asked this builder,
+    // so workers should keep the reference.
+    Shard& local();
+
+    Shard finish(bool preserve_order = true);
+
+    size_t shards() const;
+    size_t size() const;
+
+private:
+    struct ShardEntry {
+        uint64_t owner;
+        Shard values;
+    };
+
+    // Threads are told apart by serial numbers: unlike std::thread::id, they are never reused.
+    struct LocalShard {
+        uint64_t thread;
+        uint64_t builder;
+        Shard* shard;
+    };
+
+    // A piece of a shard relocated by one task.
+    struct Piece {
+        Shard* shard;
+        size_t first;
+        size_t last;
+        size_t target;
+    };
+
+    // Trivially copyable elements move as raw bytes, unless the allocator customizes construction.
+    using BulkRelocatable = std::integral_constant<bool,
+            std::is_trivially_copyable<T>::value && std::is_same<Alloc, std::allocator<T>>::value>;
+
+    static LocalShard& last_local() noexcept;
+    static uint64_t next_id() noexcept;
+    static uint64_t next_thread() noexcept;
+
+    void relocate(const Piece& , T* target, std::true_type) noexcept;
+    void relocate(const Piece& , T* target, std::false_type);
+    void gather(Vector<Shard*>& order, size_t first, Shard& result, std::true_type);
+    void gather(Vector<Shard*>& order, size_t first, Shard& result, std::false_type);
+
+    Alloc alloc_;
+    size_t threads_;
+    // Changes on finish(), so threads drop their cached shards.
+    uint64_t id_;
+    mutable std::mutex mutex_;
+    Vector<std::unique_ptr<ShardEntry>> shards_;
+};
+
+
+//////////////////////////////////////////
+//////////////////////////////////////////
+
+
+template<class T, class Alloc>
+ParallelBuilder<T, Alloc>::ParallelBuilder(size_t threads, const Alloc& init_alloc) :
+    alloc_(init_alloc),
+    threads_(threads != 0 ? threads : std::max<size_t>(1, std::thread::hardware_concurrency())),
+    id_(next_id()) {}
+
+template<class T, class Alloc>
+typename ParallelBuilder<T, Alloc>::Shard& ParallelBuilder<T, Alloc>::local() {
+    LocalShard& last = last_local();
+    if (last.builder == id_) {
+        return *last.shard;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (last.thread == 0) {
+        last.thread = next_thread();
+    }
+    Shard* shard = nullptr;
+    for (size_t i = 0; i < shards_.size() && shard == nullptr; ++i) {
+        if (shards_[i]->owner == last.thread) {
+            shard = &shards_[i]->values;
+        }
+    }
+    if (shard == nullptr) {
+        std::unique_ptr<ShardEntry> entry(new ShardEntry{last.thread, Shard(alloc_)});
+        shard = &entry->values;
+        shards_.push_back(std::move(entry));
+    }
+    last.builder = id_;
+    last.shard = shard;
+    return *shard;
+}
+
+template<class T, class Alloc>
+typename ParallelBuilder<T, Alloc>::Shard ParallelBuilder<T, Alloc>::finish(bool preserve_order) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Vector<Shard*> order;
+    order.reserve(shards_.size());
+    size_t total = 0;
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        order.push_back(&shards_[i]->values);
+        total += shards_[i]->values.size();
+    }
+
+    if (!preserve_order) {
+        for (size_t i = 1; i < order.size(); ++i) {
+            if (order[i]->capacity() > order[0]->capacity()) {
+                std::swap(order[0], order[i]);
+            }
+        }
+    }
+
+    Shard result(alloc_);
+    size_t first = 0;
+    if (!order.empty() && order[0]->capacity() >= total) {
+        result = std::move(*order[0]);
+        first = 1;
+    }
+    try {
+        gather(order, first, result, std::is_nothrow_move_constructible<T>());
+    } catch (...) {
+        if (first != 0) {
+            *order[0] = std::move(result);
+        }
+        throw;
+    }
+
+    // Shards may be large, so their moved-from elements and buffers are released in parallel too.
+    sorting::parallel_for(order.size(), threads_, [&](size_t shard) {
+        *order[shard] = Shard(alloc_);
+    });
+    shards_ = Vector<std::unique_ptr<ShardEntry>>();
+    id_ = next_id();
+    return result;
+}
+
+template<class T, class Alloc>
+size_t ParallelBuilder<T, Alloc>::shards() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return shards_.size();
+}
+
+template<class T, class Alloc>
+size_t ParallelBuilder<T, Alloc>::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        total += shards_[i]->values.size();
+    }
+    return total;
+}
+
+
+template<class T, class Alloc>
+typename ParallelBuilder<T, Alloc>::LocalShard& ParallelBuilder<T, Alloc>::last_local() noexcept {
+    static thread_local LocalShard last{0, 0, nullptr};
+    return last;
+}
+
+// Ids and serial numbers start from 1, so 0 is never cached.
+template<class T, class Alloc>
+uint64_t ParallelBuilder<T, Alloc>::next_id() noexcept {
+    static std::atomic<uint64_t> last_id{0};
+    return last_id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+template<class T, class Alloc>
+uint64_t ParallelBuilder<T, Alloc>::next_thread() noexcept {
+    static std::atomic<uint64_t> last_thread{0};
+    return last_thread.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+template<class T, class Alloc>
+void ParallelBuilder<T, Alloc>::relocate(const Piece& piece, T* target, std::true_type) noexcept {
+    std::memcpy(static_cast<void*>(target), static_cast<const void*>(piece.shard->data() + piece.first),
+                (piece.last - piece.first) * sizeof(T));
+}
+
+template<class T, class Alloc>
+void ParallelBuilder<T, Alloc>::relocate(const Piece& piece, T* target, std::false_type) {
+    T* source = piece.shard->data();
+    for (size_t i = piece.first; i < piece.last; ++i, ++target) {
+        std::allocator_traits<Alloc>::construct(alloc_, target, std::move(source[i]));
+    }
+}
+
+// Nothrow moves: the shards are cut into pieces of about 256 KiB, moved in parallel.
+template<class T, class Alloc>
+void ParallelBuilder<T, Alloc>::gather(Vector<Shard*>& order, size_t first, Shard& result, std::true_type) {
+    const size_t piece_size = std::max<size_t>(1, (256 << 10) / sizeof(T));
+    Vector<Piece> pieces;
+    size_t count = 0;
+    for (size_t i = first; i < order.size(); ++i) {
+        for (size_t begin = 0; begin < order[i]->size(); begin += piece_size) {
+            const size_t end = std::min(order[i]->size(), begin + piece_size);
+            pieces.push_back(Piece{order[i], begin, end, count + begin});
+        }
+        count += order[i]->size();
+    }
+
+    T* target = result.reserve_back(count);
+    sorting::parallel_for(pieces.size(), threads_, [&](size_t piece) {
+        this->relocate(pieces[piece], target + pieces[piece].target, BulkRelocatable());
+    });
+    result.commit(count);
+}
+
+// Moves that may throw: copies, and on failure destroys what it built.
+template<class T, class Alloc>
+void ParallelBuilder<T, Alloc>::gather(Vector<Shard*>& order, size_t first, Shard& result, std::false_type) {
+    size_t count = 0;
+    for (size_t i = first; i < order.size(); ++i) {
+        count += order[i]->size();
+    }
+
+    T* target = nullptr;
+    size_t constructed = 0;
+    try {
+        target = result.reserve_back(count);
+        for (size_t i = first; i < order.size(); ++i) {
+            for (size_t j = 0; j < order[i]->size(); ++j, ++constructed) {
+                const T& element = (*order[i])[j];
+                std::allocator_traits<Alloc>::construct(alloc_, target + constructed, element);
+            }
+        }
+    } catch (...) {
+        for (size_t i = 0; i < constructed; ++i) {
+            std::allocator_traits<Alloc>::destroy(alloc_, target + i);
+        }
+        throw;
+    }
+    result.commit(count);
+}
+
+
+#endif //PARALLEL_BUILDER_H
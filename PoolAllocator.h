@@ -0,0 +1,346 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+
+#include "Vector.h"
+
+// Buffer recycling for Vectors that repeatedly grow and shrink.
+// Requests up to 1 MiB are rounded up to a power-of-two size class and served
+// from a per-thread cache of released buffers before falling back to the
+// global allocator. Larger requests always go to the global allocator.
+//
+// Every buffer starts with a header naming its size class and the cache of
+// the thread that allocated it. A buffer released on that thread goes back to
+// its cache, unless the cache already holds cache_limit() bytes. A buffer
+// released on another thread is pushed onto the owner's lock-free remote list,
+// which the owner drains when its own list for a class runs empty.
+//
+// When a thread exits, its cache is closed: cached buffers return to the
+// global allocator, and buffers released to the closed cache later go there
+// directly. Closed caches are reopened by new threads instead of allocating
+// new ones.
+class BufferPool {
+public:
+    static const size_t min_class = 5;    // 32 bytes
+    static const size_t max_class = 20;   // 1 MiB
+
+    // usable receives the size of the returned buffer, at least bytes.
+    static void* allocate(size_t bytes, size_t& usable);
+    static void deallocate(void* ) noexcept;
+
+    // Returns every buffer cached by the calling thread to the global allocator.
+    static void trim() noexcept;
+    static size_t cached_bytes() noexcept;
+
+    // Bound on the bytes cached by each thread.
+    static void set_cache_limit(size_t ) noexcept;
+    static size_t cache_limit() noexcept;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct ThreadCache {
+        FreeBlock* lists[max_class + 1] = {};
+        size_t cached_bytes = 0;
+        std::atomic<FreeBlock*> remote{nullptr};
+        ThreadCache* next_closed = nullptr;
+    };
+
+    struct alignas(std::max_align_t) BlockHeader {
+        ThreadCache* owner;
+        size_t size_class;
+    };
+
+    struct ThreadState {
+        ThreadCache* cache;
+        bool exited;
+    };
+
+    struct ThreadExit {
+        ~ThreadExit();
+    };
+
+    struct ClosedCaches {
+        std::mutex mutex;
+        ThreadCache* head = nullptr;
+    };
+
+    static const size_t large_class = std::numeric_limits<size_t>::max();
+
+    static ThreadState& state() noexcept;
+    static ThreadCache* current();
+    static ClosedCaches& closed_caches();
+    static std::atomic<size_t>& limit() noexcept;
+    static FreeBlock* closed_marker() noexcept;
+
+    static BlockHeader* header_of(void* ) noexcept;
+    static void release(FreeBlock* ) noexcept;
+    static void cache(ThreadCache* , FreeBlock* , size_t size_class) noexcept;
+    static void push_remote(ThreadCache* , FreeBlock* ) noexcept;
+    static void drain_remote(ThreadCache* ) noexcept;
+    static void close(ThreadCache* ) noexcept;
+};
+
+
+// Stateless allocator over BufferPool; any instance frees memory of any other.
+// allocate_at_least() reports the whole size class, so Vector grows into it.
+template <class T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t );
+    AllocationResult<T*> allocate_at_least(size_t );
+    void deallocate(T* , size_t ) noexcept;
+};
+
+template <class T, class U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept {
+    return false;
+}
+
+
+//////////////////////////////////////////
+//////////////////////////////////////////
+
+
+inline void* BufferPool::allocate(size_t bytes, size_t& usable) {
+    size_t size_class = min_class;
+    while (size_class <= max_class && (size_t(1) << size_class) < bytes) {
+        ++size_class;
+    }
+
+    if (size_class > max_class) {
+        if (bytes > std::numeric_limits<size_t>::max() - sizeof(BlockHeader)) {
+            throw std::bad_alloc();
+        }
+        BlockHeader* header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + bytes));
+        header->owner = nullptr;
+        header->size_class = large_class;
+        usable = bytes;
+        return header + 1;
+    }
+
+    usable = size_t(1) << size_class;
+    ThreadCache* owner = current();
+    if (owner != nullptr) {
+        if (owner->lists[size_class] == nullptr) {
+            drain_remote(owner);
+        }
+        FreeBlock* block = owner->lists[size_class];
+        if (block != nullptr) {
+            owner->lists[size_class] = block->next;
+            owner->cached_bytes -= usable;
+            return block;
+        }
+    }
+
+    BlockHeader* header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + usable));
+    header->owner = owner;
+    header->size_class = size_class;
+    return header + 1;
+}
+
+inline void BufferPool::deallocate(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    BlockHeader* header = header_of(ptr);
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    if (header->size_class == large_class || header->owner == nullptr) {
+        release(block);
+    } else if (header->owner == state().cache) {
+        cache(header->owner, block, header->size_class);
+    } else {
+        push_remote(header->owner, block);
+    }
+}
+
+inline void BufferPool::trim() noexcept {
+    ThreadCache* owner = state().cache;
+    if (owner == nullptr) {
+        return;
+    }
+    drain_remote(owner);
+    for (size_t size_class = min_class; size_class <= max_class; ++size_class) {
+        while (owner->lists[size_class] != nullptr) {
+            FreeBlock* block = owner->lists[size_class];
+            owner->lists[size_class] = block->next;
+            release(block);
+        }
+    }
+    owner->cached_bytes = 0;
+}
+
+inline size_t BufferPool::cached_bytes() noexcept {
+    ThreadCache* owner = state().cache;
+    return owner == nullptr ? 0 : owner->cached_bytes;
+}
+
+inline void BufferPool::set_cache_limit(size_t bytes) noexcept {
+    limit().store(bytes, std::memory_order_relaxed);
+}
+
+inline size_t BufferPool::cache_limit() noexcept {
+    return limit().load(std::memory_order_relaxed);
+}
+
+
+// Trivially destructible, so it stays usable while other thread-local objects are destroyed.
+inline BufferPool::ThreadState& BufferPool::state() noexcept {
+    static thread_local ThreadState thread_state{nullptr, false};
+    return thread_state;
+}
+
+inline BufferPool::ThreadExit::~ThreadExit() {
+    ThreadState& thread_state = state();
+    if (thread_state.cache != nullptr) {
+        close(thread_state.cache);
+    }
+    thread_state.cache = nullptr;
+    thread_state.exited = true;
+}
+
+// Threads that are exiting allocate straight from the global allocator.
+inline BufferPool::ThreadCache* BufferPool::current() {
+    ThreadState& thread_state = state();
+    if (thread_state.cache == nullptr && !thread_state.exited) {
+        static thread_local ThreadExit thread_exit;
+        (void)thread_exit;
+
+        ClosedCaches& closed = closed_caches();
+        std::lock_guard<std::mutex> lock(closed.mutex);
+        if (closed.head != nullptr) {
+            thread_state.cache = closed.head;
+            closed.head = closed.head->next_closed;
+            thread_state.cache->remote.store(nullptr, std::memory_order_release);
+        } else {
+            thread_state.cache = new ThreadCache();
+        }
+    }
+    return thread_state.cache;
+}
+
+// Never destroyed: buffers may be released after static destructors have run.
+inline BufferPool::ClosedCaches& BufferPool::closed_caches() {
+    static ClosedCaches* closed = new ClosedCaches();
+    return *closed;
+}
+
+inline std::atomic<size_t>& BufferPool::limit() noexcept {
+    static std::atomic<size_t> cache_limit{size_t(8) << 20};
+    return cache_limit;
+}
+
+inline BufferPool::FreeBlock* BufferPool::closed_marker() noexcept {
+    static FreeBlock marker{nullptr};
+    return &marker;
+}
+
+inline BufferPool::BlockHeader* BufferPool::header_of(void* ptr) noexcept {
+    return static_cast<BlockHeader*>(ptr) - 1;
+}
+
+inline void BufferPool::release(FreeBlock* block) noexcept {
+    ::operator delete(header_of(block));
+}
+
+inline void BufferPool::cache(ThreadCache* owner, FreeBlock* block, size_t size_class) noexcept {
+    const size_t bytes = size_t(1) << size_class;
+    if (owner->cached_bytes + bytes > cache_limit()) {
+        release(block);
+        return;
+    }
+    block->next = owner->lists[size_class];
+    owner->lists[size_class] = block;
+    owner->cached_bytes += bytes;
+}
+
+inline void BufferPool::push_remote(ThreadCache* owner, FreeBlock* block) noexcept {
+    FreeBlock* head = owner->remote.load(std::memory_order_relaxed);
+    do {
+        if (head == closed_marker()) {
+            release(block);
+            return;
+        }
+        block->next = head;
+    } while (!owner->remote.compare_exchange_weak(head, block, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+}
+
+// Only the owning thread takes the remote list, and it takes it whole, so there is no ABA.
+inline void BufferPool::drain_remote(ThreadCache* owner) noexcept {
+    if (owner->remote.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+    FreeBlock* block = owner->remote.exchange(nullptr, std::memory_order_acquire);
+    while (block != nullptr) {
+        FreeBlock* next = block->next;
+        cache(owner, block, header_of(block)->size_class);
+        block = next;
+    }
+}
+
+inline void BufferPool::close(ThreadCache* owner) noexcept {
+    FreeBlock* block = owner->remote.exchange(closed_marker(), std::memory_order_acquire);
+    while (block != nullptr) {
+        FreeBlock* next = block->next;
+        release(block);
+        block = next;
+    }
+    for (size_t size_class = min_class; size_class <= max_class; ++size_class) {
+        while (owner->lists[size_class] != nullptr) {
+            block = owner->lists[size_class];
+            owner->lists[size_class] = block->next;
+            release(block);
+        }
+    }
+    owner->cached_bytes = 0;
+
+    ClosedCaches& closed = closed_caches();
+    std::lock_guard<std::mutex> lock(closed.mutex);
+    owner->next_closed = closed.head;
+    closed.head = owner;
+}
+
+
+template<class T>
+T* PoolAllocator<T>::allocate(size_t count) {
+    return this->allocate_at_least(count).ptr;
+}
+
+template<class T>
+AllocationResult<T*> PoolAllocator<T>::allocate_at_least(size_t count) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "the pool cannot satisfy over-aligned types");
+
+    if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+        throw std::bad_alloc();
+    }
+    size_t usable = 0;
+    T* ptr = static_cast<T*>(BufferPool::allocate(count * sizeof(T), usable));
+    return {ptr, usable / sizeof(T)};
+}
+
+template<class T>
+void PoolAllocator<T>::deallocate(T* ptr, size_t) noexcept {
+    BufferPool::deallocate(ptr);
+}
+
+
+#endif //POOL_ALLOCATOR_H
@@ -0,0 +1,362 @@
+#ifndef PUBLISHED_VECTOR_H
+#define PUBLISHED_VECTOR_H
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+#include "Vector.h"
+
+// Read-mostly Vector with RCU-style publication.
+// Writers build a new version and publish it atomically; readers pin the
+// current version through a Snapshot without taking any lock. Replaced
+// versions are reclaimed with epochs once no reader can still observe them.
+//
+// Every reader thread registers once through reader(). Reader::read() is
+// wait-free: it loads the global epoch, announces it in the reader's slot
+// and loads the current version. There is no limit on readers: slots come in
+// segments of 64, 128, 256, ... and a new segment is added when all are taken.
+template <class T, class Alloc = std::allocator<T>>
+class PublishedVector {
+    static const size_t inactive = 0;
+
+    // One slot per registered reader, on its own cache line.
+    struct alignas(64) ReaderSlot {
+        std::atomic<size_t> epoch{inactive};
+        std::atomic<bool> used{false};
+    };
+
+public:
+    class Reader;
+    class Snapshot;
+
+    explicit PublishedVector(Vector<T, Alloc> = Vector<T, Alloc>());
+    ~PublishedVector();
+
+    PublishedVector(const PublishedVector&) = delete;
+    PublishedVector& operator=(const PublishedVector&) = delete;
+
+    Reader reader();
+
+    void publish(Vector<T, Alloc> );
+    template <class Editor>
+    void update(Editor edit);
+
+    void reclaim();
+    size_t retired() const;
+
+
+    class Reader {
+    public:
+        Reader(Reader&& ) noexcept;
+        Reader& operator=(Reader&& ) & noexcept;
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        ~Reader();
+
+        Snapshot read();
+
+    private:
+        friend class PublishedVector;
+        Reader(PublishedVector* , ReaderSlot* );
+        void release() noexcept;
+
+        PublishedVector* owner_ = nullptr;
+        ReaderSlot* slot_ = nullptr;
+    };
+
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& ) noexcept;
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&& ) = delete;
+        ~Snapshot();
+
+        const Vector<T, Alloc>& operator*() const noexcept;
+        const Vector<T, Alloc>* operator->() const noexcept;
+        const Vector<T, Alloc>& get() const noexcept;
+
+    private:
+        friend class Reader;
+        Snapshot(std::atomic<size_t>* , const Vector<T, Alloc>* );
+
+        std::atomic<size_t>* epoch_ = nullptr;
+        const Vector<T, Alloc>* value_ = nullptr;
+    };
+
+
+private:
+    struct Node {
+        explicit Node(Vector<T, Alloc>&& init_value) : value(std::move(init_value)) {}
+
+        Vector<T, Alloc> value;
+        size_t retire_epoch = 0;
+        Node* next = nullptr;
+    };
+
+    static const size_t first_segment = 64;
+    static const size_t max_segments = 32;
+
+    static size_t segment_size(size_t segment) noexcept;
+    ReaderSlot* claim_slot(size_t segment) noexcept;
+    void publish_locked(Node* );
+    void reclaim_locked();
+
+    std::atomic<Node*> current_;
+    std::atomic<size_t> epoch_{1};
+
+    // Segments are published with seq_cst stores: a writer that has not seen a
+    // segment yet cannot have missed an epoch announced in it (see reclaim_locked).
+    std::atomic<ReaderSlot*> segments_[max_segments];
+    void* segment_memory_[max_segments] = {};
+    std::mutex segment_mutex_;
+
+    mutable std::mutex writer_mutex_;
+    Node* retired_ = nullptr;
+    size_t retired_count_ = 0;
+};
+
+
+//////////////////////////////////////////
+//////////////////////////////////////////
+
+
+template<class T, class Alloc>
+PublishedVector<T, Alloc>::PublishedVector(Vector<T, Alloc> init_value) :
+    current_(new Node(std::move(init_value))) {
+
+    for (size_t segment = 0; segment < max_segments; ++segment) {
+        segments_[segment].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<class T, class Alloc>
+PublishedVector<T, Alloc>::~PublishedVector() {
+    delete current_.load();
+    while (retired_ != nullptr) {
+        Node* next = retired_->next;
+        delete retired_;
+        retired_ = next;
+    }
+    // ReaderSlot is trivially destructible, so only the memory is released.
+    for (size_t segment = 0; segment < max_segments; ++segment) {
+        ::operator delete(segment_memory_[segment]);
+    }
+}
+
+template<class T, class Alloc>
+typename PublishedVector<T, Alloc>::Reader PublishedVector<T, Alloc>::reader() {
+    for (size_t segment = 0; segment < max_segments; ++segment) {
+        if (segments_[segment].load() == nullptr) {
+            std::lock_guard<std::mutex> lock(segment_mutex_);
+            if (segments_[segment].load() == nullptr) {
+                // Over-allocated by one slot, since operator new does not align to cache lines.
+                const size_t size = segment_size(segment);
+                void* memory = ::operator new((size + 1) * sizeof(ReaderSlot));
+                void* aligned = memory;
+                size_t space = (size + 1) * sizeof(ReaderSlot);
+                std::align(alignof(ReaderSlot), size * sizeof(ReaderSlot), aligned, space);
+
+                ReaderSlot* slots = static_cast<ReaderSlot*>(aligned);
+                for (size_t i = 0; i < size; ++i) {
+                    new (slots + i) ReaderSlot();
+                }
+                slots[0].used.store(true, std::memory_order_relaxed);
+                segment_memory_[segment] = memory;
+                segments_[segment].store(slots);
+                return Reader(this, slots);
+            }
+        }
+        if (ReaderSlot* slot = claim_slot(segment)) {
+            return Reader(this, slot);
+        }
+    }
+    throw std::length_error("All reader slots of PublishedVector are taken");
+}
+
+template<class T, class Alloc>
+size_t PublishedVector<T, Alloc>::segment_size(size_t segment) noexcept {
+    return first_segment << segment;
+}
+
+template<class T, class Alloc>
+typename PublishedVector<T, Alloc>::ReaderSlot* PublishedVector<T, Alloc>::claim_slot(size_t segment) noexcept {
+    ReaderSlot* slots = segments_[segment].load();
+    for (size_t i = 0; i < segment_size(segment); ++i) {
+        bool expected = false;
+        if (!slots[i].used.load(std::memory_order_relaxed) &&
+                slots[i].used.compare_exchange_strong(expected, true)) {
+            return slots + i;
+        }
+    }
+    return nullptr;
+}
+
+template<class T, class Alloc>
+void PublishedVector<T, Alloc>::publish(Vector<T, Alloc> next_value) {
+    std::unique_ptr<Node> next(new Node(std::move(next_value)));
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    publish_locked(next.release());
+}
+
+template<class T, class Alloc>
+template<class Editor>
+void PublishedVector<T, Alloc>::update(Editor edit) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    std::unique_ptr<Node> next(new Node(Vector<T, Alloc>(current_.load()->value)));
+    edit(next->value);
+    publish_locked(next.release());
+}
+
+template<class T, class Alloc>
+void PublishedVector<T, Alloc>::reclaim() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    reclaim_locked();
+}
+
+template<class T, class Alloc>
+size_t PublishedVector<T, Alloc>::retired() const {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return retired_count_;
+}
+
+template<class T, class Alloc>
+void PublishedVector<T, Alloc>::publish_locked(Node* next) {
+    Node* old = current_.exchange(next);
+    old->retire_epoch = epoch_.fetch_add(1);
+    old->next = retired_;
+    retired_ = old;
+    ++retired_count_;
+
+    reclaim_locked();
+}
+
+template<class T, class Alloc>
+void PublishedVector<T, Alloc>::reclaim_locked() {
+    // A version retired at epoch e may still be pinned by readers that announced e or earlier.
+    // A reader in a segment added after this scan announced its epoch after the
+    // exchange in publish_locked(), so it can only load the new version.
+    size_t oldest_reader = std::numeric_limits<size_t>::max();
+    for (size_t segment = 0; segment < max_segments; ++segment) {
+        ReaderSlot* slots = segments_[segment].load();
+        if (slots == nullptr) {
+            break;
+        }
+        for (size_t i = 0; i < segment_size(segment); ++i) {
+            size_t reader_epoch = slots[i].epoch.load();
+            if (reader_epoch != inactive && reader_epoch < oldest_reader) {
+                oldest_reader = reader_epoch;
+            }
+        }
+    }
+
+    Node** link = &retired_;
+    while (*link != nullptr) {
+        Node* node = *link;
+        if (node->retire_epoch < oldest_reader) {
+            *link = node->next;
+            delete node;
+            --retired_count_;
+        } else {
+            link = &node->next;
+        }
+    }
+}
+
+
+template<class T, class Alloc>
+PublishedVector<T, Alloc>::Reader::Reader(PublishedVector* owner, ReaderSlot* slot) :
+    owner_(owner),
+    slot_(slot) {}
+
+template<class T, class Alloc>
+PublishedVector<T, Alloc>::Reader::Reader(Reader&& other_reader) noexcept :
+    owner_(other_reader.owner_),
+    slot_(other_reader.slot_) {
+
+    other_reader.owner_ = nullptr;
+}
+
+template<class T, class Alloc>
+typename PublishedVector<T, Alloc>::Reader&
+        PublishedVector<T, Alloc>::Reader::operator=(Reader&& other_reader) & noexcept {
+
+    if (this != &other_reader) {
+        release();
+        owner_ = other_reader.owner_;
+        slot_ = other_reader.slot_;
+        other_reader.owner_ = nullptr;
+    }
+    return (*this);
+}
+
+template<class T, class Alloc>
+PublishedVector<T, Alloc>::Reader::~Reader() {
+    release();
+}
+
+template<class T, class Alloc>
+void PublishedVector<T, Alloc>::Reader::release() noexcept {
+    if (owner_ != nullptr) {
+        slot_->used.store(false, std::memory_order_release);
+        owner_ = nullptr;
+    }
+}
+
+template<class T, class Alloc>
+typename PublishedVector<T, Alloc>::Snapshot PublishedVector<T, Alloc>::Reader::read() {
+    if (owner_ == nullptr) {
+        throw std::logic_error("reading through a released reader");
+    }
+    std::atomic<size_t>& slot_epoch = slot_->epoch;
+    if (slot_epoch.load(std::memory_order_relaxed) != inactive) {
+        throw std::logic_error("reader already holds a snapshot");
+    }
+
+    slot_epoch.store(owner_->epoch_.load());
+    return Snapshot(&slot_epoch, &owner_->current_.load()->value);
+}
+
+
+template<class T, class Alloc>
+PublishedVector<T, Alloc>::Snapshot::Snapshot(std::atomic<size_t>* epoch, const Vector<T, Alloc>* value) :
+    epoch_(epoch),
+    value_(value) {}
+
+template<class T, class Alloc>
+PublishedVector<T, Alloc>::Snapshot::Snapshot(Snapshot&& other_snapshot) noexcept :
+    epoch_(other_snapshot.epoch_),
+    value_(other_snapshot.value_) {
+
+    other_snapshot.epoch_ = nullptr;
+    other_snapshot.value_ = nullptr;
+}
+
+template<class T, class Alloc>
+PublishedVector<T, Alloc>::Snapshot::~Snapshot() {
+    if (epoch_ != nullptr) {
+        epoch_->store(inactive, std::memory_order_release);
+    }
+}
+
+template<class T, class Alloc>
+const Vector<T, Alloc>& PublishedVector<T, Alloc>::Snapshot::operator*() const noexcept {
+    return *value_;
+}
+
+template<class T, class Alloc>
+const Vector<T, Alloc>* PublishedVector<T, Alloc>::Snapshot::operator->() const noexcept {
+    return value_;
+}
+
+template<class T, class Alloc>
+const Vector<T, Alloc>& PublishedVector<T, Alloc>::Snapshot::get() const noexcept {
+    return *value_;
+}
+
+
+#endif //PUBLISHED_VECTOR_H
@@ -0,0 +1,487 @@
+#ifndef RING_VECTOR_H
+#define RING_VECTOR_H
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Vector.h"
+
+// Double-ended queue over a circular buffer.
+// Capacity is always a power of two, so positions wrap with a mask.
+// push_back, emplace_back, pop_front and pop_back are O(1); growth doubles
+// the capacity and unwraps the elements to the front of the new buffer.
+// Unlike Vector, removing elements never shrinks the buffer: call
+// shrink_to_fit() when the memory should be returned.
+// Like Vector, growth, reserve, shrink_to_fit and copy assignment leave the
+// ring unchanged when an element constructor throws, except that copy
+// assignment into a buffer already large enough reuses it and keeps only the
+// elements copied so far.
+template <class T, class Alloc = std::allocator<T>>
+class RingVector {
+public:
+    explicit RingVector(const Alloc& = Alloc());
+    ~RingVector();
+
+    RingVector(const RingVector&);
+    RingVector(RingVector&&) noexcept;
+    RingVector& operator=(const RingVector&) &;
+    RingVector& operator=(RingVector&&) & noexcept;
+
+    void push_back(const T& );
+    void push_back(T&& );
+    template <class... Args>
+    void emplace_back(Args&&... args);
+    void pop_front();
+    void pop_back();
+
+    void clear();
+    void reserve(size_t );
+    void shrink_to_fit();
+
+    T& operator [](size_t );
+    T& at(size_t );
+    T& front() noexcept;
+    T& back() noexcept;
+
+    const T& operator [](size_t ) const;
+    const T& at(size_t ) const;
+    const T& front() const noexcept;
+    const T& back() const noexcept;
+
+    bool empty() const noexcept;
+    size_t capacity() const noexcept;
+    size_t size() const noexcept;
+
+private:
+    using StorageGuard = ::StorageGuard<T, Alloc>;
+
+    static size_t round_up_capacity(size_t );
+
+    // Relocates the elements into guard.arr, unwrapped to the front.
+    void relocate_to(StorageGuard& guard);
+    void replace_storage(StorageGuard& guard) noexcept;
+    void reallocate(size_t new_capacity);
+
+    size_t head_ = 0, size_ = 0, capacity_ = 0;
+    Alloc alloc_ = Alloc();
+    T* arr_ = nullptr;
+    using traits = std::allocator_traits<Alloc>;
+};
+
+
+// Bounded single-producer/single-consumer queue.
+// One thread calls try_push/try_emplace and one thread calls try_pop; neither
+// takes a lock. Each side keeps a cached copy of the other side's position and
+// reloads it only when the queue looks full (producer) or empty (consumer).
+template <class T, class Alloc = std::allocator<T>>
+class SpscRingVector {
+public:
+    explicit SpscRingVector(size_t capacity, const Alloc& = Alloc());
+    ~SpscRingVector();
+
+    SpscRingVector(const SpscRingVector&) = delete;
+    SpscRingVector& operator=(const SpscRingVector&) = delete;
+
+    bool try_push(const T& );
+    bool try_push(T&& );
+    template <class... Args>
+    bool try_emplace(Args&&... args);
+    bool try_pop(T& );
+
+    bool empty() const noexcept;
+    size_t capacity() const noexcept;
+    size_t size() const noexcept;
+
+private:
+    using traits = std::allocator_traits<Alloc>;
+
+    Alloc alloc_;
+    size_t capacity_;
+    T* arr_;
+
+    // Positions only grow; the slot of position p is p & (capacity_ - 1).
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+};
+
+
+//////////////////////////////////////////
+//////////////////////////////////////////
+
+
+template<class T, class Alloc>
+RingVector<T, Alloc>::RingVector(const Alloc& init_alloc) :
+    alloc_(init_alloc) {}
+
+template<class T, class Alloc>
+RingVector<T, Alloc>::~RingVector() {
+    this->clear();
+}
+
+template<class T, class Alloc>
+RingVector<T, Alloc>::RingVector(const RingVector& other_ring) :
+    alloc_(traits::select_on_container_copy_construction(other_ring.alloc_)) {
+
+    if (other_ring.size_ == 0) {
+        return;
+    }
+    const size_t new_capacity = round_up_capacity(other_ring.size_);
+    StorageGuard guard(alloc_, traits::allocate(alloc_, new_capacity), new_capacity);
+    for (; guard.constructed < other_ring.size_; ++guard.constructed) {
+        traits::construct(alloc_, guard.arr + guard.constructed, other_ring[guard.constructed]);
+    }
+    size_ = other_ring.size_;
+    capacity_ = new_capacity;
+    arr_ = guard.release();
+}
+
+template<class T, class Alloc>
+RingVector<T, Alloc>::RingVector(RingVector&& other_ring) noexcept :
+    head_(other_ring.head_),
+    size_(other_ring.size_),
+    capacity_(other_ring.capacity_),
+    alloc_(std::move(other_ring.alloc_)),
+    arr_(other_ring.arr_) {
+
+    other_ring.head_ = other_ring.size_ = other_ring.capacity_ = 0;
+    other_ring.arr_ = nullptr;
+}
+
+template<class T, class Alloc>
+RingVector<T, Alloc>& RingVector<T, Alloc>::operator=(const RingVector& other_ring) & {
+    if (this != &other_ring) {
+        bool alloc_copy_req = traits::propagate_on_container_copy_assignment::value;
+        bool realloc_req = (capacity_ < other_ring.size_) || (alloc_copy_req && alloc_ != other_ring.alloc_);
+
+        if (realloc_req) {
+            // The copy is built aside, so a throwing copy leaves this ring unchanged.
+            Alloc new_alloc = alloc_copy_req ? other_ring.alloc_ : alloc_;
+            const size_t new_capacity = other_ring.size_ == 0 ? 0 : round_up_capacity(other_ring.size_);
+            StorageGuard guard(new_alloc, new_capacity == 0 ? nullptr : traits::allocate(new_alloc, new_capacity),
+                               new_capacity);
+            for (; guard.constructed < other_ring.size_; ++guard.constructed) {
+                traits::construct(new_alloc, guard.arr + guard.constructed, other_ring[guard.constructed]);
+            }
+
+            this->clear();
+            alloc_ = new_alloc;
+            size_ = other_ring.size_;
+            capacity_ = new_capacity;
+            arr_ = guard.release();
+        } else {
+            for (size_t i = 0; i < size_; ++i) {
+                traits::destroy(alloc_, &(*this)[i]);
+            }
+            head_ = size_ = 0;
+            if (alloc_copy_req) {
+                alloc_ = other_ring.alloc_;
+            }
+
+            // Copying into the existing buffer: a throwing copy leaves the elements copied so far.
+            while (size_ < other_ring.size_) {
+                traits::construct(alloc_, arr_ + size_, other_ring[size_]);
+                ++size_;
+            }
+        }
+    }
+    return (*this);
+}
+
+template<class T, class Alloc>
+RingVector<T, Alloc>& RingVector<T, Alloc>::operator=(RingVector&& other_ring) & noexcept {
+    if (this != &other_ring) {
+        this->clear();
+        if (!traits::propagate_on_container_move_assignment::value && alloc_ != other_ring.alloc_) {
+            this->reserve(other_ring.size_);
+            for (size_t i = 0; i < other_ring.size_; ++i) {
+                traits::construct(alloc_, arr_ + i, std::move(other_ring[i]));
+                ++size_;
+            }
+            other_ring.clear();
+        } else {
+            if (traits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(other_ring.alloc_);
+            }
+            head_ = other_ring.head_;
+            size_ = other_ring.size_;
+            capacity_ = other_ring.capacity_;
+            arr_ = other_ring.arr_;
+
+            other_ring.head_ = other_ring.size_ = other_ring.capacity_ = 0;
+            other_ring.arr_ = nullptr;
+        }
+    }
+    return (*this);
+}
+
+
+template<class T, class Alloc>
+size_t RingVector<T, Alloc>::round_up_capacity(size_t count) {
+    size_t capacity = 1;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::relocate_to(StorageGuard& guard) {
+    const size_t first_part = size_ < capacity_ - head_ ? size_ : capacity_ - head_;
+    guard.relocate(arr_ + head_, first_part, arr_, size_ - first_part);
+}
+
+// Frees the old buffer, whose elements relocate_to has destroyed, and takes
+// over the guarded one.
+template<class T, class Alloc>
+void RingVector<T, Alloc>::replace_storage(StorageGuard& guard) noexcept {
+    if (arr_ != nullptr) {
+        traits::deallocate(alloc_, arr_, capacity_);
+    }
+    capacity_ = guard.capacity;
+    arr_ = guard.release();
+    head_ = 0;
+}
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::reallocate(size_t new_capacity) {
+    StorageGuard guard(alloc_, new_capacity == 0 ? nullptr : traits::allocate(alloc_, new_capacity), new_capacity);
+    relocate_to(guard);
+    replace_storage(guard);
+}
+
+
+// The new element is constructed before the old ones are relocated, so
+// arguments that refer into the ring stay valid. If anything throws, the
+// guard frees the new buffer and the ring is left unchanged.
+#define ringPushBack(method_argument_transmission) { \
+    if (size_ < capacity_) { \
+        traits::construct(alloc_, arr_ + ((head_ + size_) & (capacity_ - 1)), method_argument_transmission); \
+    } else { \
+        size_t new_capacity = capacity_ == 0 ? 1 : 2 * capacity_; \
+        StorageGuard guard(alloc_, traits::allocate(alloc_, new_capacity), new_capacity); \
+        traits::construct(alloc_, guard.arr + size_, method_argument_transmission); \
+        guard.extra = guard.arr + size_; \
+        relocate_to(guard); \
+        replace_storage(guard); \
+    } \
+    ++size_; \
+}
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::push_back(const T& value) {
+    ringPushBack(value)
+}
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::push_back(T&& value) {
+    ringPushBack(std::move(value))
+}
+
+template<class T, class Alloc>
+template<class... Args>
+void RingVector<T, Alloc>::emplace_back(Args &&... args) {
+    ringPushBack(std::forward<Args>(args)...)
+}
+
+#undef ringPushBack
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::pop_front() {
+    if (this->empty()) {
+        throw std::logic_error("deleting from empty array");
+    }
+    traits::destroy(alloc_, arr_ + head_);
+    head_ = (head_ + 1) & (capacity_ - 1);
+    --size_;
+}
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::pop_back() {
+    if (this->empty()) {
+        throw std::logic_error("deleting from empty array");
+    }
+    --size_;
+    traits::destroy(alloc_, arr_ + ((head_ + size_) & (capacity_ - 1)));
+}
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::clear() {
+    for (size_t i = 0; i < size_; ++i) {
+        traits::destroy(alloc_, &(*this)[i]);
+    }
+    if (arr_ != nullptr) {
+        traits::deallocate(alloc_, arr_, capacity_);
+    }
+
+    arr_ = nullptr;
+    head_ = size_ = capacity_ = 0;
+}
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::reserve(size_t new_capacity) {
+    if (new_capacity > capacity_) {
+        reallocate(round_up_capacity(new_capacity));
+    }
+}
+
+template<class T, class Alloc>
+void RingVector<T, Alloc>::shrink_to_fit() {
+    const size_t new_capacity = size_ == 0 ? 0 : round_up_capacity(size_);
+    if (new_capacity != capacity_) {
+        reallocate(new_capacity);
+    }
+}
+
+
+template<class T, class Alloc>
+T& RingVector<T, Alloc>::operator[](size_t ind) {
+    return arr_[(head_ + ind) & (capacity_ - 1)];
+}
+
+template<class T, class Alloc>
+T& RingVector<T, Alloc>::at(size_t ind) {
+    if (ind >= size_) {
+        throw std::out_of_range("Accessing a nonexistent array element");
+    }
+    return (*this)[ind];
+}
+
+template<class T, class Alloc>
+T& RingVector<T, Alloc>::front() noexcept {
+    return arr_[head_];
+}
+
+template<class T, class Alloc>
+T& RingVector<T, Alloc>::back() noexcept {
+    return (*this)[size_ - 1];
+}
+
+template<class T, class Alloc>
+const T& RingVector<T, Alloc>::operator[](size_t ind) const {
+    return arr_[(head_ + ind) & (capacity_ - 1)];
+}
+
+template<class T, class Alloc>
+const T& RingVector<T, Alloc>::at(size_t ind) const {
+    if (ind >= size_) {
+        throw std::out_of_range("Accessing a nonexistent array element");
+    }
+    return (*this)[ind];
+}
+
+template<class T, class Alloc>
+const T& RingVector<T, Alloc>::front() const noexcept {
+    return arr_[head_];
+}
+
+template<class T, class Alloc>
+const T& RingVector<T, Alloc>::back() const noexcept {
+    return (*this)[size_ - 1];
+}
+
+template<class T, class Alloc>
+bool RingVector<T, Alloc>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<class T, class Alloc>
+size_t RingVector<T, Alloc>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<class T, class Alloc>
+size_t RingVector<T, Alloc>::size() const noexcept {
+    return size_;
+}
+
+
+//////////////////////////////////////////
+//////////////////////////////////////////
+
+
+template<class T, class Alloc>
+SpscRingVector<T, Alloc>::SpscRingVector(size_t capacity, const Alloc& init_alloc) :
+    alloc_(init_alloc),
+    capacity_(1),
+    arr_(nullptr) {
+
+    while (capacity_ < capacity) {
+        capacity_ *= 2;
+    }
+    arr_ = traits::allocate(alloc_, capacity_);
+}
+
+template<class T, class Alloc>
+SpscRingVector<T, Alloc>::~SpscRingVector() {
+    const size_t tail = tail_.load();
+    for (size_t position = head_.load(); position != tail; ++position) {
+        traits::destroy(alloc_, arr_ + (position & (capacity_ - 1)));
+    }
+    traits::deallocate(alloc_, arr_, capacity_);
+}
+
+template<class T, class Alloc>
+bool SpscRingVector<T, Alloc>::try_push(const T& value) {
+    return try_emplace(value);
+}
+
+template<class T, class Alloc>
+bool SpscRingVector<T, Alloc>::try_push(T&& value) {
+    return try_emplace(std::move(value));
+}
+
+template<class T, class Alloc>
+template<class... Args>
+bool SpscRingVector<T, Alloc>::try_emplace(Args&&... args) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == capacity_) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail - cached_head_ == capacity_) {
+            return false;
+        }
+    }
+    traits::construct(alloc_, arr_ + (tail & (capacity_ - 1)), std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template<class T, class Alloc>
+bool SpscRingVector<T, Alloc>::try_pop(T& value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head == cached_tail_) {
+            return false;
+        }
+    }
+    T* slot = arr_ + (head & (capacity_ - 1));
+    value = std::move(*slot);
+    traits::destroy(alloc_, slot);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// Exact only while neither side is running; otherwise a snapshot.
+template<class T, class Alloc>
+bool SpscRingVector<T, Alloc>::empty() const noexcept {
+    return this->size() == 0;
+}
+
+template<class T, class Alloc>
+size_t SpscRingVector<T, Alloc>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<class T, class Alloc>
+size_t SpscRingVector<T, Alloc>::size() const noexcept {
+    const size_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+}
+
+
+#endif //RING_VECTOR_H
@@ -0,0 +1,82 @@
+#ifndef SLACK_ALLOCATOR_H
+#define SLACK_ALLOCATOR_H
+
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "Vector.h"
+
+// malloc-backed allocator that reports the usable size of every block,
+// so Vector grows into the allocator's size classes instead of past them.
+// The block is resized to its usable size before that is reported, so the
+// slack is owned by the caller rather than written past the requested size.
+template <class T>
+class SlackAllocator {
+public:
+    using value_type = T;
+
+    SlackAllocator() = default;
+    template <class U>
+    SlackAllocator(const SlackAllocator<U>&) noexcept {}
+
+    T* allocate(size_t );
+    AllocationResult<T*> allocate_at_least(size_t );
+    void deallocate(T* , size_t ) noexcept;
+};
+
+template <class T, class U>
+bool operator==(const SlackAllocator<T>&, const SlackAllocator<U>&) noexcept {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const SlackAllocator<T>&, const SlackAllocator<U>&) noexcept {
+    return false;
+}
+
+
+template<class T>
+T* SlackAllocator<T>::allocate(size_t count) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc cannot satisfy over-aligned types");
+
+    if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+        throw std::bad_alloc();
+    }
+    void* ptr = std::malloc(count * sizeof(T));
+    if (ptr == nullptr && count != 0) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T*>(ptr);
+}
+
+template<class T>
+AllocationResult<T*> SlackAllocator<T>::allocate_at_least(size_t count) {
+    T* ptr = allocate(count);
+#if defined(__GLIBC__)
+    if (ptr != nullptr) {
+        const size_t usable = malloc_usable_size(ptr) / sizeof(T);
+        if (usable > count) {
+            // glibc grows a block within its usable size in place.
+            void* resized = std::realloc(ptr, usable * sizeof(T));
+            if (resized != nullptr) {
+                ptr = static_cast<T*>(resized);
+                count = usable;
+            }
+        }
+    }
+#endif
+    return {ptr, count};
+}
+
+template<class T>
+void SlackAllocator<T>::deallocate(T* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+
+#endif //SLACK_ALLOCATOR_H
@@ -0,0 +1,282 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "Vector.h"
+
+// Handle to an element of a SlotMap. A handle stays valid until its element
+// is erased; after that it is stale, even when the slot is reused.
+struct SlotHandle {
+    uint32_t index;
+    uint32_t generation;
+};
+
+inline bool operator==(const SlotHandle& lhs, const SlotHandle& rhs) {
+    return lhs.index == rhs.index && lhs.generation == rhs.generation;
+}
+
+inline bool operator!=(const SlotHandle& lhs, const SlotHandle& rhs) {
+    return !(lhs == rhs);
+}
+
+
+// Unordered container addressed by generational handles.
+// Values are kept contiguous in a Vector, so iteration runs over dense storage.
+// A handle names a slot; the slot stores the value's dense position and a
+// generation, odd while the slot is occupied. Free slots form an intrusive
+// list threaded through the same field. Insertion takes a free slot and
+// appends the value; erasure moves the last value into the hole.
+// Both are O(1) (amortized over Vector growth and shrinking).
+//
+// Iterators and pointers to values are invalidated by insert and erase;
+// handles are not.
+template <class T, class Alloc = std::allocator<T>>
+class SlotMap {
+public:
+    using Handle = SlotHandle;
+    using Iterator = typename Vector<T, Alloc>::Iterator;
+    using ConstIterator = typename Vector<T, Alloc>::ConstIterator;
+
+    explicit SlotMap(const Alloc& = Alloc());
+
+    Handle insert(const T& );
+    Handle insert(T&& );
+    template <class... Args>
+    Handle emplace(Args&&... args);
+    bool erase(Handle );
+    void clear();
+    void reserve(size_t );
+
+    bool contains(Handle ) const noexcept;
+    T* get(Handle ) noexcept;
+    T& at(Handle );
+    const T* get(Handle ) const noexcept;
+    const T& at(Handle ) const;
+
+    // Handle of the value at a dense position, for use while iterating.
+    Handle handle_of(size_t ) const;
+
+    Iterator begin() noexcept;
+    Iterator end() noexcept;
+    ConstIterator begin() const noexcept;
+    ConstIterator end() const noexcept;
+    T* data() noexcept;
+    const T* data() const noexcept;
+
+    bool empty() const noexcept;
+    size_t size() const noexcept;
+
+private:
+    struct Slot {
+        uint32_t position;   // dense position while occupied, next free slot otherwise
+        uint32_t generation;
+    };
+
+    using IndexAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<uint32_t>;
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+
+    static const uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    uint32_t acquire_slot();
+
+    Vector<T, Alloc> values_;
+    Vector<uint32_t, IndexAlloc> slot_of_;
+    Vector<Slot, SlotAlloc> slots_;
+    uint32_t free_head_ = npos;
+};
+
+
+//////////////////////////////////////////
+//////////////////////////////////////////
+
+
+template<class T, class Alloc>
+const uint32_t SlotMap<T, Alloc>::npos;
+
+template<class T, class Alloc>
+SlotMap<T, Alloc>::SlotMap(const Alloc& init_alloc) :
+    values_(init_alloc),
+    slot_of_(IndexAlloc(init_alloc)),
+    slots_(SlotAlloc(init_alloc)) {}
+
+template<class T, class Alloc>
+typename SlotMap<T, Alloc>::Handle SlotMap<T, Alloc>::insert(const T& value) {
+    return this->emplace(value);
+}
+
+template<class T, class Alloc>
+typename SlotMap<T, Alloc>::Handle SlotMap<T, Alloc>::insert(T&& value) {
+    return this->emplace(std::move(value));
+}
+
+// The value is appended first, so a throwing constructor leaves the map unchanged.
+template<class T, class Alloc>
+template<class... Args>
+typename SlotMap<T, Alloc>::Handle SlotMap<T, Alloc>::emplace(Args&&... args) {
+    if (values_.size() == npos) {
+        throw std::length_error("SlotMap is full");
+    }
+    values_.emplace_back(std::forward<Args>(args)...);
+    uint32_t index;
+    try {
+        slot_of_.push_back(npos);
+        index = acquire_slot();
+    } catch (...) {
+        if (slot_of_.size() == values_.size()) {
+            slot_of_.pop_back();
+        }
+        values_.pop_back();
+        throw;
+    }
+
+    Slot& slot = slots_[index];
+    slot.position = static_cast<uint32_t>(values_.size() - 1);
+    ++slot.generation;
+    slot_of_.back() = index;
+    return Handle{index, slot.generation};
+}
+
+template<class T, class Alloc>
+uint32_t SlotMap<T, Alloc>::acquire_slot() {
+    if (free_head_ != npos) {
+        uint32_t index = free_head_;
+        free_head_ = slots_[index].position;
+        return index;
+    }
+    slots_.push_back(Slot{npos, 0});
+    return static_cast<uint32_t>(slots_.size() - 1);
+}
+
+template<class T, class Alloc>
+bool SlotMap<T, Alloc>::erase(Handle handle) {
+    if (!this->contains(handle)) {
+        return false;
+    }
+    Slot& slot = slots_[handle.index];
+    const uint32_t position = slot.position;
+    const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+    if (position != last) {
+        values_[position] = std::move(values_[last]);
+        slot_of_[position] = slot_of_[last];
+        slots_[slot_of_[position]].position = position;
+    }
+    values_.pop_back();
+    slot_of_.pop_back();
+
+    // A slot whose generation wraps around is retired, so old handles never match again.
+    ++slot.generation;
+    if (slot.generation != 0) {
+        slot.position = free_head_;
+        free_head_ = handle.index;
+    }
+    return true;
+}
+
+template<class T, class Alloc>
+void SlotMap<T, Alloc>::clear() {
+    for (uint32_t position = 0; position < slot_of_.size(); ++position) {
+        Slot& slot = slots_[slot_of_[position]];
+        ++slot.generation;
+        if (slot.generation != 0) {
+            slot.position = free_head_;
+            free_head_ = slot_of_[position];
+        }
+    }
+    values_.clear();
+    slot_of_.clear();
+}
+
+template<class T, class Alloc>
+void SlotMap<T, Alloc>::reserve(size_t new_capacity) {
+    values_.reserve(new_capacity);
+    slot_of_.reserve(new_capacity);
+    slots_.reserve(new_capacity);
+}
+
+
+template<class T, class Alloc>
+bool SlotMap<T, Alloc>::contains(Handle handle) const noexcept {
+    return handle.index < slots_.size() && handle.generation % 2 == 1 &&
+           slots_[handle.index].generation == handle.generation;
+}
+
+template<class T, class Alloc>
+T* SlotMap<T, Alloc>::get(Handle handle) noexcept {
+    return this->contains(handle) ? values_.data() + slots_[handle.index].position : nullptr;
+}
+
+template<class T, class Alloc>
+T& SlotMap<T, Alloc>::at(Handle handle) {
+    if (!this->contains(handle)) {
+        throw std::out_of_range("Accessing an erased SlotMap element");
+    }
+    return values_[slots_[handle.index].position];
+}
+
+template<class T, class Alloc>
+const T* SlotMap<T, Alloc>::get(Handle handle) const noexcept {
+    return this->contains(handle) ? values_.data() + slots_[handle.index].position : nullptr;
+}
+
+template<class T, class Alloc>
+const T& SlotMap<T, Alloc>::at(Handle handle) const {
+    if (!this->contains(handle)) {
+        throw std::out_of_range("Accessing an erased SlotMap element");
+    }
+    return values_[slots_[handle.index].position];
+}
+
+template<class T, class Alloc>
+typename SlotMap<T, Alloc>::Handle SlotMap<T, Alloc>::handle_of(size_t position) const {
+    const uint32_t index = slot_of_.at(position);
+    return Handle{index, slots_[index].generation};
+}
+
+
+template<class T, class Alloc>
+typename SlotMap<T, Alloc>::Iterator SlotMap<T, Alloc>::begin() noexcept {
+    return values_.begin();
+}
+
+template<class T, class Alloc>
+typename SlotMap<T, Alloc>::Iterator SlotMap<T, Alloc>::end() noexcept {
+    return values_.end();
+}
+
+template<class T, class Alloc>
+typename SlotMap<T, Alloc>::ConstIterator SlotMap<T, Alloc>::begin() const noexcept {
+    return values_.begin();
+}
+
+template<class T, class Alloc>
+typename SlotMap<T, Alloc>::ConstIterator SlotMap<T, Alloc>::end() const noexcept {
+    return values_.end();
+}
+
+template<class T, class Alloc>
+T* SlotMap<T, Alloc>::data() noexcept {
+    return values_.data();
+}
+
+template<class T, class Alloc>
+const T* SlotMap<T, Alloc>::data() const noexcept {
+    return values_.data();
+}
+
+template<class T, class Alloc>
+bool SlotMap<T, Alloc>::empty() const noexcept {
+    return values_.empty();
+}
+
+template<class T, class Alloc>
+size_t SlotMap<T, Alloc>::size() const noexcept {
+    return values_.size();
+}
+
+
+#endif //SLOT_MAP_H
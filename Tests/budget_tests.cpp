@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include "../Vector.h"
+#include "instrumented.h"
+
+// Exact budgets of allocator calls and element operations. Any change
+// that adds per-element work or extra allocations fails here.
+
+using TrackedVector = Vector<Tracked, CountingAllocator<Tracked>>;
+using ThrowingMoveVector = Vector<ThrowingMoveTracked, CountingAllocator<ThrowingMoveTracked>>;
+
+static TrackedVector make_tracked(size_t size, int allocator_id = 0) {
+    TrackedVector result{CountingAllocator<Tracked>(allocator_id)};
+    result.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        result.emplace_back(static_cast<int>(i));
+    }
+    return result;
+}
+
+TEST(Budget, EmplaceBackAfterReserve) {
+    const size_t n = 1000;
+    TrackedVector v;
+
+    reset_operation_counts();
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.emplace_back(static_cast<int>(i));
+    }
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 1);
+    EXPECT_EQ(counts.allocated_elements, n);
+    EXPECT_EQ(counts.constructions, n);
+    EXPECT_EQ(counts.moves, 0);
+    EXPECT_EQ(counts.copies, 0);
+    EXPECT_EQ(counts.destructions, 0);
+}
+
+TEST(Budget, PushBackRvalueAfterReserve) {
+    const size_t n = 1000;
+    TrackedVector v;
+    v.reserve(n);
+
+    reset_operation_counts();
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(Tracked(static_cast<int>(i)));
+    }
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 0);
+    EXPECT_EQ(counts.moves, n);
+    EXPECT_EQ(counts.copies, 0);
+    EXPECT_EQ(counts.destructions, n);
+}
+
+TEST(Budget, GrowthMovesNothrowElements) {
+    TrackedVector v;
+
+    reset_operation_counts();
+    for (int i = 0; i < 1024; ++i) {
+        v.emplace_back(i);
+    }
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 11);
+    EXPECT_EQ(counts.deallocations, 10);
+    EXPECT_EQ(counts.moves, 1023);
+    EXPECT_EQ(counts.copies, 0);
+    EXPECT_EQ(counts.destructions, 1023);
+}
+
+TEST(Budget, GrowthCopiesThrowingMoveElements) {
+    ThrowingMoveVector v;
+
+    reset_operation_counts();
+    for (int i = 0; i < 1024; ++i) {
+        v.emplace_back(i);
+    }
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 11);
+    EXPECT_EQ(counts.copies, 1023);
+    EXPECT_EQ(counts.moves, 0);
+}
+
+TEST(Budget, MoveConstruction) {
+    TrackedVector source = make_tracked(100);
+
+    reset_operation_counts();
+    TrackedVector target(std::move(source));
+    EXPECT_EQ(operation_counts().allocations, 0);
+    EXPECT_EQ(operation_counts().deallocations, 0);
+    EXPECT_EQ(operation_counts().element_operations(), 0);
+    EXPECT_EQ(target.size(), 100);
+}
+
+TEST(Budget, MoveAssignmentEqualAllocators) {
+    TrackedVector source = make_tracked(100);
+    TrackedVector target;
+
+    reset_operation_counts();
+    target = std::move(source);
+    EXPECT_EQ(operation_counts().allocations, 0);
+    EXPECT_EQ(operation_counts().element_operations(), 0);
+
+    // a non-empty target only pays for releasing its own elements
+    TrackedVector other = make_tracked(30);
+    reset_operation_counts();
+    target = std::move(other);
+    EXPECT_EQ(operation_counts().allocations, 0);
+    EXPECT_EQ(operation_counts().deallocations, 1);
+    EXPECT_EQ(operation_counts().destructions, 100);
+    EXPECT_EQ(operation_counts().element_operations(), 100);
+}
+
+TEST(Budget, MoveAssignmentUnequalAllocators) {
+    TrackedVector source = make_tracked(100, 1);
+    TrackedVector target{CountingAllocator<Tracked>(2)};
+
+    reset_operation_counts();
+    target = std::move(source);
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 1);
+    EXPECT_EQ(counts.allocated_elements, 100);
+    EXPECT_EQ(counts.moves, 100);
+    EXPECT_EQ(counts.copies, 0);
+}
+
+TEST(Budget, CopyConstructionAllocatesSize) {
+    TrackedVector source = make_tracked(600);
+    source.reserve(1024);
+
+    reset_operation_counts();
+    TrackedVector target(source);
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 1);
+    EXPECT_EQ(counts.allocated_elements, 600);
+    EXPECT_EQ(counts.copies, 600);
+    EXPECT_EQ(counts.element_operations(), 600);
+}
+
+TEST(Budget, CopyAssignmentReusesStorage) {
+    TrackedVector source = make_tracked(600);
+    TrackedVector target = make_tracked(1000);
+
+    reset_operation_counts();
+    target = source;
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 0);
+    EXPECT_EQ(counts.copies, 600);
+    EXPECT_EQ(counts.destructions, 1000);
+}
+
+TEST(Budget, CopyAssignmentAllocatesSize) {
+    TrackedVector source = make_tracked(600);
+    TrackedVector target = make_tracked(10);
+
+    reset_operation_counts();
+    target = source;
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 1);
+    EXPECT_EQ(counts.allocated_elements, 600);
+    EXPECT_EQ(counts.copies, 600);
+}
+
+TEST(Budget, ShrinkToFit) {
+    TrackedVector v = make_tracked(100);
+    v.reserve(1000);
+
+    reset_operation_counts();
+    v.shrink_to_fit();
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 1);
+    EXPECT_EQ(counts.allocated_elements, 100);
+    EXPECT_EQ(counts.moves, 100);
+    EXPECT_EQ(counts.copies, 0);
+    EXPECT_EQ(counts.destructions, 100);
+}
+
+TEST(Budget, PopBackShrinksOnce) {
+    TrackedVector v;
+    for (int i = 0; i < 5; ++i) {
+        v.emplace_back(i);
+    }
+    ASSERT_EQ(v.capacity(), 8);
+
+    reset_operation_counts();
+    v.pop_back();
+    v.pop_back();
+    EXPECT_EQ(operation_counts().allocations, 0);
+    v.pop_back();
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 1);
+    EXPECT_EQ(counts.allocated_elements, 4);
+    EXPECT_EQ(counts.moves, 2);
+    EXPECT_EQ(counts.destructions, 3 + 2);
+}
+
+TEST(Budget, ResizeAllocatesOnce) {
+    TrackedVector v;
+
+    reset_operation_counts();
+    v.resize(500, Tracked(7));
+    const OperationCounts& counts = operation_counts();
+    EXPECT_EQ(counts.allocations, 1);
+    EXPECT_EQ(counts.allocated_elements, 500);
+    EXPECT_EQ(counts.copies, 500);
+    EXPECT_EQ(counts.moves, 0);
+}
+
+TEST(Budget, Clear) {
+    TrackedVector v = make_tracked(100);
+
+    reset_operation_counts();
+    v.clear();
+    EXPECT_EQ(operation_counts().deallocations, 1);
+    EXPECT_EQ(operation_counts().destructions, 100);
+    EXPECT_EQ(operation_counts().element_operations(), 100);
+}
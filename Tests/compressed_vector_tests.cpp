@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "../CompressedVector.h"
+#include <cstdint>
+#include <limits>
+#include <random>
+
+template <class Int>
+static void check_equal(const CompressedVector<Int>& compressed, const Vector<Int>& expected) {
+    ASSERT_EQ(compressed.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(compressed[i], expected[i]) << "at " << i;
+    }
+
+    size_t ind = 0;
+    compressed.for_each([&](Int value) {
+        ASSERT_EQ(value, expected[ind]) << "at " << ind;
+        ++ind;
+    });
+    EXPECT_EQ(ind, expected.size());
+    EXPECT_TRUE(compressed.to_vector() == expected);
+}
+
+template <class Int>
+static Vector<Int> random_values(size_t size, Int low, Int high, std::mt19937_64& generator) {
+    std::uniform_int_distribution<int64_t> distribution(low, high);
+    Vector<Int> result;
+    for (size_t i = 0; i < size; ++i) {
+        result.push_back(static_cast<Int>(distribution(generator)));
+    }
+    return result;
+}
+
+TEST(CompressedVector, PushBackSealsBlocks) {
+    CompressedVector<uint32_t> compressed;
+    Vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        compressed.push_back(i * 7 + i % 3);
+        expected.push_back(i * 7 + i % 3);
+        ASSERT_EQ(compressed.size(), i + 1);
+        ASSERT_EQ(compressed.blocks(), (i + 1) / CompressedVector<uint32_t>::block_size);
+    }
+    check_equal(compressed, expected);
+}
+
+TEST(CompressedVector, RoundTrip) {
+    std::mt19937_64 generator(7);
+    for (size_t size: {0, 1, 255, 256, 257, 1000, 4096}) {
+        Vector<int64_t> wide = random_values<int64_t>(size, std::numeric_limits<int64_t>::min(),
+                                                      std::numeric_limits<int64_t>::max(), generator);
+        check_equal(CompressedVector<int64_t>(wide), wide);
+
+        Vector<int32_t> narrow = random_values<int32_t>(size, -100, 100, generator);
+        check_equal(CompressedVector<int32_t>(narrow), narrow);
+
+        Vector<int8_t> bytes = random_values<int8_t>(size, -128, 127, generator);
+        check_equal(CompressedVector<int8_t>(bytes), bytes);
+
+        Vector<uint16_t> constant;
+        for (size_t i = 0; i < size; ++i) {
+            constant.push_back(uint16_t(60000));
+        }
+        check_equal(CompressedVector<uint16_t>(constant), constant);
+    }
+}
+
+TEST(CompressedVector, MonotonicExtremes) {
+    Vector<int64_t> values;
+    values.push_back(std::numeric_limits<int64_t>::min());
+    for (int i = 1; i < 600; ++i) {
+        values.push_back(values.back() + (int64_t(1) << 54));
+    }
+    check_equal(CompressedVector<int64_t>(values), values);
+
+    Vector<uint64_t> steps;
+    for (uint64_t i = 0; i < 600; ++i) {
+        steps.push_back(i < 300 ? i : std::numeric_limits<uint64_t>::max() - 600 + i);
+    }
+    check_equal(CompressedVector<uint64_t>(steps), steps);
+}
+
+TEST(CompressedVector, MonotonicIdsCompress) {
+    std::mt19937_64 generator(11);
+    std::uniform_int_distribution<uint64_t> gap(1, 16);
+    Vector<uint64_t> ids;
+    uint64_t id = uint64_t(1) << 40;
+    for (size_t i = 0; i < 100000; ++i) {
+        ids.push_back(id += gap(generator));
+    }
+
+    CompressedVector<uint64_t> compressed(ids);
+    check_equal(compressed, ids);
+    EXPECT_LT(compressed.memory_usage() * 6, ids.size() * sizeof(uint64_t));
+}
+
+TEST(CompressedVector, Access) {
+    Vector<int> values;
+    for (int i = 0; i < 300; ++i) {
+        values.push_back(i);
+    }
+    CompressedVector<int> compressed(values);
+    EXPECT_EQ(compressed.at(299), 299);
+    EXPECT_THROW(compressed.at(300), std::out_of_range);
+    EXPECT_THROW(compressed.decode_block(1, values.data()), std::out_of_range);
+
+    compressed.clear();
+    EXPECT_TRUE(compressed.empty());
+    EXPECT_EQ(compressed.blocks(), 0);
+    compressed.push_back(-5);
+    EXPECT_EQ(compressed[0], -5);
+}
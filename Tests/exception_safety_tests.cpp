@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "../Vector.h"
+#include "instrumented.h"
+
+// Elements whose move may throw are relocated by copy, so a failing copy
+// during reallocation must leave the Vector exactly as it was.
+
+using ThrowingVector = Vector<ThrowingMoveTracked, CountingAllocator<ThrowingMoveTracked>>;
+
+static ThrowingVector make_throwing(size_t size) {
+    ThrowingVector result;
+    for (size_t i = 0; i < size; ++i) {
+        result.emplace_back(static_cast<int>(i));
+    }
+    return result;
+}
+
+static void fail_after_copies(size_t copies) {
+    reset_operation_counts();
+    operation_counts().copies_until_failure = copies;
+}
+
+static void expect_unchanged(const ThrowingVector& v, size_t size, size_t capacity,
+                             const ThrowingMoveTracked* data) {
+    ASSERT_EQ(v.size(), size);
+    EXPECT_EQ(v.capacity(), capacity);
+    EXPECT_EQ(v.data(), data);
+    for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(v[i].value, static_cast<int>(i));
+    }
+    // every element built in the abandoned buffer was destroyed, and the buffer freed
+    EXPECT_EQ(operation_counts().live_elements(), 0);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+}
+
+TEST(ExceptionSafety, PushBackGrowth) {
+    ThrowingVector v = make_throwing(16);
+    const ThrowingMoveTracked* data = v.data();
+
+    ThrowingMoveTracked extra(16);
+    for (size_t failing_copy = 0; failing_copy <= 16; ++failing_copy) {
+        fail_after_copies(failing_copy);
+        EXPECT_THROW(v.push_back(extra), CopyFailure);
+        expect_unchanged(v, 16, 16, data);
+    }
+
+    // the argument may refer into the Vector
+    fail_after_copies(5);
+    EXPECT_THROW(v.push_back(v[0]), CopyFailure);
+    expect_unchanged(v, 16, 16, data);
+}
+
+TEST(ExceptionSafety, EmplaceBackGrowth) {
+    ThrowingVector v = make_throwing(8);
+    const ThrowingMoveTracked* data = v.data();
+
+    fail_after_copies(3);
+    EXPECT_THROW(v.emplace_back(8), CopyFailure);
+    // the element constructed in the new buffer was destroyed with it
+    EXPECT_EQ(operation_counts().constructions, 1);
+    expect_unchanged(v, 8, 8, data);
+
+    v.emplace_back(8);
+    EXPECT_EQ(v.size(), 9);
+    EXPECT_EQ(v[8].value, 8);
+}
+
+TEST(ExceptionSafety, ReserveAndShrink) {
+    ThrowingVector v = make_throwing(10);
+    v.reserve(40);
+    const ThrowingMoveTracked* data = v.data();
+
+    fail_after_copies(9);
+    EXPECT_THROW(v.reserve(100), CopyFailure);
+    expect_unchanged(v, 10, 40, data);
+
+    fail_after_copies(4);
+    EXPECT_THROW(v.shrink_to_fit(), CopyFailure);
+    expect_unchanged(v, 10, 40, data);
+
+    reset_operation_counts();
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 10);
+    EXPECT_EQ(operation_counts().copies, 10);
+    EXPECT_EQ(operation_counts().moves, 0);
+}
+
+TEST(ExceptionSafety, Constructors) {
+    ThrowingVector source = make_throwing(20);
+
+    fail_after_copies(7);
+    EXPECT_THROW(ThrowingVector copy(source), CopyFailure);
+    EXPECT_EQ(operation_counts().live_elements(), 0);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+
+    fail_after_copies(12);
+    {
+        ThrowingMoveTracked value(3);
+        EXPECT_THROW(ThrowingVector filled(20, value), CopyFailure);
+    }
+    EXPECT_EQ(operation_counts().live_elements(), 0);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+}
+
+TEST(ExceptionSafety, ShrinkingEraseKeepsBuffer) {
+    ThrowingVector v = make_throwing(16);
+    for (size_t i = 0; i < 11; ++i) {
+        v.pop_back();
+    }
+    const ThrowingMoveTracked* data = v.data();
+
+    // the shrink fails, the element is still removed and the buffer kept
+    fail_after_copies(2);
+    EXPECT_NO_THROW(v.pop_back());
+    ASSERT_EQ(v.size(), 4);
+    EXPECT_EQ(v.capacity(), 16);
+    EXPECT_EQ(v.data(), data);
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(v[i].value, static_cast<int>(i));
+    }
+    // the popped element, then the two copies made before the failure
+    EXPECT_EQ(operation_counts().copies, 2);
+    EXPECT_EQ(operation_counts().destructions, 3);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+
+    ThrowingMoveTracked fill(-1);
+    fail_after_copies(0);
+    EXPECT_NO_THROW(v.resize(1, fill));
+    ASSERT_EQ(v.size(), 1);
+    EXPECT_EQ(v.capacity(), 16);
+    EXPECT_EQ(v.data(), data);
+    EXPECT_EQ(v[0].value, 0);
+    EXPECT_EQ(operation_counts().destructions, 3);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+
+    // without failures the buffer shrinks as usual
+    reset_operation_counts();
+    v = make_throwing(16);
+    for (size_t i = 0; i < 12; ++i) {
+        v.pop_back();
+    }
+    EXPECT_EQ(v.capacity(), 8);
+}
+
+TEST(ExceptionSafety, CopyAssignment) {
+    ThrowingVector source = make_throwing(20);
+
+    // a target without room is copied into a new buffer: strong guarantee
+    ThrowingVector small = make_throwing(5);
+    const ThrowingMoveTracked* small_data = small.data();
+    const size_t small_capacity = small.capacity();
+    fail_after_copies(6);
+    EXPECT_THROW(small = source, CopyFailure);
+    expect_unchanged(small, 5, small_capacity, small_data);
+
+    // a target with room is copied in place: basic guarantee,
+    // the elements copied so far remain and nothing leaks
+    ThrowingVector large = make_throwing(30);
+    fail_after_copies(6);
+    EXPECT_THROW(large = source, CopyFailure);
+    ASSERT_EQ(large.size(), 6);
+    for (size_t i = 0; i < 6; ++i) {
+        ASSERT_EQ(large[i].value, static_cast<int>(i));
+    }
+    EXPECT_EQ(operation_counts().copies, 6);
+    EXPECT_EQ(operation_counts().destructions, 30);
+
+    reset_operation_counts();
+    small = source;
+    ASSERT_EQ(small.size(), 20);
+    EXPECT_EQ(operation_counts().copies, 20);
+    EXPECT_EQ(operation_counts().allocations, 1);
+    EXPECT_EQ(operation_counts().deallocations, 1);
+}
+
+TEST(ExceptionSafety, NothrowMovesNeverCopy) {
+    Vector<Tracked> v;
+    reset_operation_counts();
+    operation_counts().copies_until_failure = 0;
+    for (int i = 0; i < 100; ++i) {
+        v.emplace_back(i);
+    }
+    v.reserve(1000);
+    v.shrink_to_fit();
+    EXPECT_EQ(operation_counts().copies, 0);
+    EXPECT_EQ(v.size(), 100);
+}
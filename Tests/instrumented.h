@@ -0,0 +1,124 @@
+#ifndef VECTOR_TESTS_INSTRUMENTED_H
+#define VECTOR_TESTS_INSTRUMENTED_H
+
+#include <cstddef>
+#include <memory>
+
+// Counts the work Vector does: allocator calls and element operations.
+struct OperationCounts {
+    size_t allocations = 0;
+    size_t allocated_elements = 0;
+    size_t deallocations = 0;
+
+    size_t constructions = 0;
+    size_t copies = 0;
+    size_t moves = 0;
+    size_t assignments = 0;
+    size_t destructions = 0;
+
+    // The copy that finds this at zero throws CopyFailure.
+    size_t copies_until_failure = static_cast<size_t>(-1);
+
+    size_t element_operations() const {
+        return constructions + copies + moves + assignments + destructions;
+    }
+    size_t live_elements() const {
+        return constructions + copies + moves - destructions;
+    }
+};
+
+struct CopyFailure {};
+
+inline OperationCounts& operation_counts() {
+    static OperationCounts counts;
+    return counts;
+}
+
+inline void reset_operation_counts() {
+    operation_counts() = OperationCounts();
+}
+
+
+// Allocator that records every call. Instances compare equal when their ids match.
+template <class T>
+struct CountingAllocator {
+    using value_type = T;
+
+    explicit CountingAllocator(int init_id = 0) : id(init_id) {}
+    template <class U>
+    CountingAllocator(const CountingAllocator<U>& other) : id(other.id) {}
+
+    T* allocate(size_t count) {
+        ++operation_counts().allocations;
+        operation_counts().allocated_elements += count;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* ptr, size_t count) {
+        if (ptr != nullptr) {
+            ++operation_counts().deallocations;
+        }
+        std::allocator<T>().deallocate(ptr, count);
+    }
+
+    int id;
+};
+
+template <class T, class U>
+bool operator==(const CountingAllocator<T>& lhs, const CountingAllocator<U>& rhs) {
+    return lhs.id == rhs.id;
+}
+
+template <class T, class U>
+bool operator!=(const CountingAllocator<T>& lhs, const CountingAllocator<U>& rhs) {
+    return !(lhs == rhs);
+}
+
+
+// Element type that records its constructions, copies, moves and destructions.
+template <bool nothrow_move>
+struct BasicTracked {
+    BasicTracked(int init_value = 0) : value(init_value) {
+        ++operation_counts().constructions;
+    }
+    BasicTracked(const BasicTracked& other) : value(other.value) {
+        if (operation_counts().copies_until_failure-- == 0) {
+            throw CopyFailure();
+        }
+        ++operation_counts().copies;
+    }
+    BasicTracked(BasicTracked&& other) noexcept(nothrow_move) : value(other.value) {
+        ++operation_counts().moves;
+    }
+    BasicTracked& operator=(const BasicTracked& other) {
+        ++operation_counts().assignments;
+        value = other.value;
+        return *this;
+    }
+    BasicTracked& operator=(BasicTracked&& other) noexcept(nothrow_move) {
+        ++operation_counts().assignments;
+        value = other.value;
+        return *this;
+    }
+    ~BasicTracked() {
+        ++operation_counts().destructions;
+    }
+
+    bool operator==(const BasicTracked& other) const {
+        return value == other.value;
+    }
+    bool operator<(const BasicTracked& other) const {
+        return value < other.value;
+    }
+    bool operator>(const BasicTracked& other) const {
+        return value > other.value;
+    }
+
+    int value;
+};
+
+using Tracked = BasicTracked<true>;
+using ThrowingMoveTracked = BasicTracked<false>;
+
+
+#endif //VECTOR_TESTS_INSTRUMENTED_H
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "../ParallelBuilder.h"
+#include "instrumented.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fills one shard per thread; thread t appends counts[t] values t * 1000000 + i.
+// The threads run one after another, so their shards are created in order.
+template <class Builder, class Make>
+static void fill_in_order(Builder& builder, const std::vector<size_t>& counts, Make make) {
+    for (size_t t = 0; t < counts.size(); ++t) {
+        std::thread worker([&, t] {
+            auto& shard = builder.local();
+            EXPECT_EQ(&builder.local(), &shard);
+            for (size_t i = 0; i < counts[t]; ++i) {
+                shard.push_back(make(static_cast<int>(t * 1000000 + i)));
+            }
+        });
+        worker.join();
+    }
+}
+
+TEST(ParallelBuilder, PreservesCreationOrder) {
+    ParallelBuilder<int> builder(4);
+    const std::vector<size_t> counts = {70000, 0, 3, 200000, 1, 150000};
+    fill_in_order(builder, counts, [](int value) { return value; });
+    EXPECT_EQ(builder.shards(), counts.size());
+    EXPECT_EQ(builder.size(), 420004);
+
+    Vector<int> result = builder.finish();
+    ASSERT_EQ(result.size(), 420004);
+    size_t position = 0;
+    for (size_t t = 0; t < counts.size(); ++t) {
+        for (size_t i = 0; i < counts[t]; ++i, ++position) {
+            ASSERT_EQ(result[position], static_cast<int>(t * 1000000 + i)) << "at " << position;
+        }
+    }
+
+    // finish() starts over
+    EXPECT_EQ(builder.shards(), 0);
+    EXPECT_EQ(builder.local().size(), 0);
+    EXPECT_TRUE(builder.finish().empty());
+}
+
+TEST(ParallelBuilder, NonTrivialElements) {
+    ParallelBuilder<std::string> builder(3);
+    const std::vector<size_t> counts = {20000, 50000, 1};
+    fill_in_order(builder, counts, [](int value) { return "element " + std::to_string(value); });
+
+    Vector<std::string> result = builder.finish();
+    ASSERT_EQ(result.size(), 70001);
+    size_t position = 0;
+    for (size_t t = 0; t < counts.size(); ++t) {
+        for (size_t i = 0; i < counts[t]; ++i, ++position) {
+            ASSERT_EQ(result[position], "element " + std::to_string(t * 1000000 + i));
+        }
+    }
+}
+
+TEST(ParallelBuilder, ConcurrentWorkers) {
+    ParallelBuilder<long> builder;
+    sorting::parallel_for(64, 4, [&](size_t task) {
+        Vector<long>& shard = builder.local();
+        for (long i = 0; i < 1000; ++i) {
+            shard.push_back(static_cast<long>(task) * 1000 + i);
+        }
+    });
+    EXPECT_LE(builder.shards(), 4);
+
+    Vector<long> result = builder.finish(false);
+    ASSERT_EQ(result.size(), 64000);
+    std::sort(result.begin(), result.end());
+    for (long i = 0; i < 64000; ++i) {
+        ASSERT_EQ(result[i], i);
+    }
+}
+
+TEST(ParallelBuilder, AdoptsShardWithRoom) {
+    ParallelBuilder<int> builder(2);
+    const int* big_data = nullptr;
+    std::thread small([&] {
+        builder.local().push_back(1);
+    });
+    small.join();
+    std::thread big([&] {
+        Vector<int>& shard = builder.local();
+        shard.reserve(1000);
+        shard.push_back(2);
+        big_data = shard.data();
+    });
+    big.join();
+
+    // in order, the small shard comes first and has no room
+    ParallelBuilder<int> ordered(2);
+    std::thread([&] { ordered.local().push_back(1); }).join();
+    std::thread([&] { ordered.local().reserve(1000); ordered.local().push_back(2); }).join();
+    Vector<int> in_order = ordered.finish();
+    ASSERT_EQ(in_order.size(), 2);
+    EXPECT_EQ(in_order[0], 1);
+    EXPECT_EQ(in_order[1], 2);
+    EXPECT_EQ(in_order.capacity(), 2);
+
+    // otherwise the big shard goes first and becomes the result
+    Vector<int> unordered = builder.finish(false);
+    ASSERT_EQ(unordered.size(), 2);
+    EXPECT_EQ(unordered.data(), big_data);
+    EXPECT_EQ(unordered[0], 2);
+    EXPECT_EQ(unordered[1], 1);
+}
+
+TEST(ParallelBuilder, ThrowingMovesKeepShards) {
+    using Builder = ParallelBuilder<ThrowingMoveTracked, CountingAllocator<ThrowingMoveTracked>>;
+    reset_operation_counts();
+    {
+        Builder builder(1);
+        fill_in_order(builder, {5, 7}, [](int value) { return ThrowingMoveTracked(value); });
+        const size_t live = operation_counts().live_elements();
+
+        operation_counts().copies_until_failure = 9;
+        EXPECT_THROW(builder.finish(), CopyFailure);
+        EXPECT_EQ(operation_counts().live_elements(), live);
+        EXPECT_EQ(builder.size(), 12);
+
+        operation_counts().copies_until_failure = static_cast<size_t>(-1);
+        const size_t copies = operation_counts().copies;
+        auto result = builder.finish();
+        // gathered by copy, in one allocation
+        EXPECT_EQ(operation_counts().copies - copies, 12);
+        ASSERT_EQ(result.size(), 12);
+        EXPECT_EQ(result.capacity(), 12);
+        EXPECT_EQ(result[4].value, 4);
+        EXPECT_EQ(result[5].value, 1000000);
+        EXPECT_EQ(result[11].value, 1000006);
+    }
+    EXPECT_EQ(operation_counts().live_elements(), 0);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+}
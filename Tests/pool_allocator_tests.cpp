@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "../PoolAllocator.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(PoolAllocator, RecyclesSizeClasses) {
+    BufferPool::trim();
+    PoolAllocator<int> alloc;
+
+    AllocationResult<int*> first = alloc.allocate_at_least(5);
+    EXPECT_EQ(first.count, 8);
+    alloc.deallocate(first.ptr, first.count);
+    EXPECT_EQ(BufferPool::cached_bytes(), 32);
+
+    // any request of the same class gets the cached buffer back
+    int* second = alloc.allocate(7);
+    EXPECT_EQ(second, first.ptr);
+    EXPECT_EQ(BufferPool::cached_bytes(), 0);
+    alloc.deallocate(second, 7);
+
+    // large requests bypass the cache
+    PoolAllocator<char> bytes;
+    char* large = bytes.allocate((size_t(1) << 20) + 1);
+    bytes.deallocate(large, (size_t(1) << 20) + 1);
+    EXPECT_EQ(BufferPool::cached_bytes(), 32);
+
+    BufferPool::trim();
+    EXPECT_EQ(BufferPool::cached_bytes(), 0);
+}
+
+TEST(PoolAllocator, CacheLimit) {
+    BufferPool::trim();
+    const size_t old_limit = BufferPool::cache_limit();
+    BufferPool::set_cache_limit(4096);
+
+    PoolAllocator<char> alloc;
+    std::vector<char*> buffers;
+    for (int i = 0; i < 10; ++i) {
+        buffers.push_back(alloc.allocate(1024));
+    }
+    for (char* buffer: buffers) {
+        alloc.deallocate(buffer, 1024);
+    }
+    EXPECT_EQ(BufferPool::cached_bytes(), 4096);
+
+    BufferPool::set_cache_limit(old_limit);
+    BufferPool::trim();
+}
+
+TEST(PoolAllocator, VectorOscillation) {
+    BufferPool::trim();
+    Vector<int, PoolAllocator<int>> a;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            a.push_back(i);
+        }
+        // capacities are whole size classes
+        ASSERT_EQ(a.capacity() & (a.capacity() - 1), 0);
+        while (a.size() > 1) {
+            a.pop_back();
+        }
+        ASSERT_EQ(a.front(), 0);
+    }
+    a.clear();
+    EXPECT_GT(BufferPool::cached_bytes(), 0);
+    BufferPool::trim();
+}
+
+TEST(PoolAllocator, RemoteFreesReturnToOwner) {
+    BufferPool::trim();
+    PoolAllocator<std::string> alloc;
+    std::vector<std::string*> buffers;
+    for (int i = 0; i < 16; ++i) {
+        buffers.push_back(alloc.allocate(3));
+    }
+
+    std::thread other([&] {
+        for (std::string* buffer: buffers) {
+            alloc.deallocate(buffer, 3);
+        }
+        EXPECT_EQ(BufferPool::cached_bytes(), 0);
+    });
+    other.join();
+
+    for (int i = 0; i < 16; ++i) {
+        std::string* buffer = alloc.allocate(3);
+        EXPECT_NE(std::find(buffers.begin(), buffers.end(), buffer), buffers.end());
+    }
+    BufferPool::trim();
+    for (std::string* buffer: buffers) {
+        alloc.deallocate(buffer, 3);
+    }
+    BufferPool::trim();
+}
+
+TEST(PoolAllocator, ThreadExit) {
+    PoolAllocator<double> alloc;
+    double* orphan = nullptr;
+    std::thread first([&] {
+        orphan = alloc.allocate(100);
+        alloc.deallocate(alloc.allocate(50), 50);
+        EXPECT_GT(BufferPool::cached_bytes(), 0);
+    });
+    first.join();
+
+    // the owner is gone, so the buffer goes to the global allocator
+    alloc.deallocate(orphan, 100);
+
+    std::thread second([&] {
+        EXPECT_EQ(BufferPool::cached_bytes(), 0);
+        Vector<double, PoolAllocator<double>> v(100, 1.5);
+        EXPECT_EQ(v[99], 1.5);
+    });
+    second.join();
+}
+
+TEST(PoolAllocator, ThreadsShareVectors) {
+    const int threads = 8;
+    std::vector<Vector<int, PoolAllocator<int>>> handoff(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            Vector<int, PoolAllocator<int>> local;
+            for (int round = 0; round < 200; ++round) {
+                for (int i = 0; i < 300; ++i) {
+                    local.push_back(i);
+                }
+                while (local.size() > 3) {
+                    local.pop_back();
+                }
+            }
+            handoff[t] = std::move(local);
+        });
+    }
+    for (std::thread& worker: workers) {
+        worker.join();
+    }
+    for (auto& v: handoff) {
+        ASSERT_EQ(v.size(), 3);
+        v.clear();
+    }
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "../PublishedVector.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+TEST(PublishedVector, PublishAndRead) {
+    PublishedVector<int> table(Vector<int>(3, 1));
+    auto reader = table.reader();
+
+    {
+        auto snapshot = reader.read();
+        ASSERT_EQ(snapshot->size(), 3);
+        ASSERT_EQ((*snapshot)[2], 1);
+    }
+
+    table.publish(Vector<int>(5, 2));
+    auto snapshot = reader.read();
+    ASSERT_EQ(snapshot->size(), 5);
+    ASSERT_EQ(snapshot.get()[4], 2);
+    ASSERT_THROW(reader.read(), std::logic_error);
+}
+
+TEST(PublishedVector, Update) {
+    PublishedVector<int> table;
+    for (int i = 0; i < 10; ++i) {
+        table.update([i](Vector<int>& value) {
+            value.push_back(i);
+        });
+    }
+
+    auto reader = table.reader();
+    auto snapshot = reader.read();
+    ASSERT_EQ(snapshot->size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(snapshot->at(i), i);
+    }
+}
+
+TEST(PublishedVector, SnapshotDelaysReclamation) {
+    PublishedVector<int> table(Vector<int>(1, 1));
+    auto reader = table.reader();
+
+    {
+        auto snapshot = reader.read();
+        table.publish(Vector<int>(2, 2));
+        table.publish(Vector<int>(3, 3));
+        EXPECT_EQ(table.retired(), 2);
+        ASSERT_EQ(snapshot->size(), 1);
+        ASSERT_EQ(snapshot->front(), 1);
+    }
+
+    table.reclaim();
+    EXPECT_EQ(table.retired(), 0);
+
+    auto snapshot = reader.read();
+    ASSERT_EQ(snapshot->size(), 3);
+    table.publish(Vector<int>(4, 4));
+    EXPECT_EQ(table.retired(), 1);
+}
+
+TEST(PublishedVector, ReaderSlots) {
+    PublishedVector<int> table(Vector<int>(1, 0));
+    auto r1 = table.reader();
+    {
+        auto r2 = table.reader();
+        ASSERT_NO_THROW(r2.read());
+    }
+    ASSERT_NO_THROW(table.reader());
+
+    auto r3 = std::move(r1);
+    ASSERT_THROW(r1.read(), std::logic_error);
+    ASSERT_NO_THROW(r3.read());
+}
+
+TEST(PublishedVector, ManyReaders) {
+    PublishedVector<int> table(Vector<int>(1, 0));
+    // fills the first three segments and starts the fourth
+    vector<PublishedVector<int>::Reader> readers;
+    for (int i = 0; i < 500; ++i) {
+        readers.push_back(table.reader());
+    }
+
+    // a snapshot pinned through the last slot still delays reclamation
+    {
+        auto snapshot = readers[readers.size() - 1].read();
+        table.publish(Vector<int>(2, 1));
+        EXPECT_EQ(table.retired(), 1);
+        EXPECT_EQ(snapshot->size(), 1);
+        EXPECT_EQ(readers.front().read()->size(), 2);
+    }
+    table.reclaim();
+    EXPECT_EQ(table.retired(), 0);
+
+    readers.clear();
+    auto reader = table.reader();
+    EXPECT_EQ(reader.read()->size(), 2);
+}
+
+TEST(PublishedVector, ConcurrentReaders) {
+    const int versions = 300;
+    PublishedVector<int> table(Vector<int>(1, 0));
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+
+    vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            auto reader = table.reader();
+            int last_seen = 0;
+            while (!done.load()) {
+                auto snapshot = reader.read();
+                int version = static_cast<int>(snapshot->size()) - 1;
+                for (const auto& elem: *snapshot) {
+                    failures += (elem != version);
+                }
+                failures += (version < last_seen);
+                last_seen = version;
+            }
+        });
+    }
+
+    for (int version = 1; version <= versions; ++version) {
+        table.publish(Vector<int>(version + 1, version));
+    }
+    done = true;
+    for (auto& reader: readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+    table.reclaim();
+    EXPECT_EQ(table.retired(), 0);
+}
@@ -0,0 +1,306 @@
+#include <gtest/gtest.h>
+#include "../RingVector.h"
+#include "instrumented.h"
+#include <deque>
+#include <random>
+#include <string>
+#include <thread>
+
+template <class T, class Alloc>
+static void check_equal(const RingVector<T, Alloc>& ring, const std::deque<T>& expected) {
+    ASSERT_EQ(ring.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(ring[i], expected[i]);
+    }
+    if (!expected.empty()) {
+        EXPECT_EQ(ring.front(), expected.front());
+        EXPECT_EQ(ring.back(), expected.back());
+    }
+}
+
+TEST(RingVector, MatchesDeque) {
+    std::mt19937 generator(3);
+    RingVector<std::string> ring;
+    std::deque<std::string> expected;
+
+    for (int step = 0; step < 20000; ++step) {
+        int operation = generator() % 8;
+        if (operation < 4 || expected.empty()) {
+            std::string value = std::to_string(step) + std::string(step % 40, 'x');
+            ring.push_back(value);
+            expected.push_back(value);
+        } else if (operation < 7) {
+            ring.pop_front();
+            expected.pop_front();
+        } else {
+            ring.pop_back();
+            expected.pop_back();
+        }
+        ASSERT_EQ(ring.capacity() & (ring.capacity() - 1), 0);
+        if (step % 97 == 0) {
+            check_equal(ring, expected);
+        }
+    }
+    check_equal(ring, expected);
+
+    RingVector<std::string> copy(ring);
+    check_equal(copy, expected);
+    RingVector<std::string> moved(std::move(copy));
+    check_equal(moved, expected);
+    EXPECT_TRUE(copy.empty());
+}
+
+TEST(RingVector, GrowthUnwraps) {
+    RingVector<int> ring;
+    for (int i = 0; i < 8; ++i) {
+        ring.push_back(i);
+    }
+    for (int i = 0; i < 5; ++i) {
+        ring.pop_front();
+    }
+    for (int i = 8; i < 13; ++i) {
+        ring.push_back(i);
+    }
+    ASSERT_EQ(ring.capacity(), 8);
+
+    ring.emplace_back(13);
+    EXPECT_EQ(ring.capacity(), 16);
+    std::deque<int> expected;
+    for (int i = 5; i < 14; ++i) {
+        expected.push_back(i);
+    }
+    check_equal(ring, expected);
+
+    // an argument referring into the ring survives the growth
+    for (int i = 0; i < 8; ++i) {
+        ring.push_back(ring.front());
+        expected.push_back(expected.front());
+    }
+    EXPECT_EQ(ring.capacity(), 32);
+    check_equal(ring, expected);
+}
+
+TEST(RingVector, DrainKeepsCapacity) {
+    using TrackedRing = RingVector<Tracked, CountingAllocator<Tracked>>;
+    TrackedRing ring;
+    ring.reserve(100);
+    EXPECT_EQ(ring.capacity(), 128);
+
+    reset_operation_counts();
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 128; ++i) {
+            ring.emplace_back(i);
+        }
+        for (int i = 0; i < 128; ++i) {
+            ASSERT_EQ(ring.front().value, i);
+            ring.pop_front();
+        }
+    }
+    EXPECT_EQ(ring.capacity(), 128);
+    EXPECT_EQ(operation_counts().allocations, 0);
+    EXPECT_EQ(operation_counts().moves, 0);
+
+    // growth relocates every element exactly once
+    for (int i = 0; i < 129; ++i) {
+        ring.emplace_back(i);
+    }
+    EXPECT_EQ(operation_counts().allocations, 1);
+    EXPECT_EQ(operation_counts().moves, 128);
+
+    ring.clear();
+    ring.emplace_back(1);
+    ring.shrink_to_fit();
+    EXPECT_EQ(ring.capacity(), 1);
+    EXPECT_EQ(ring.front().value, 1);
+}
+
+TEST(RingVector, Errors) {
+    RingVector<int> ring;
+    EXPECT_THROW(ring.pop_front(), std::logic_error);
+    EXPECT_THROW(ring.pop_back(), std::logic_error);
+    ring.push_back(1);
+    EXPECT_EQ(ring.at(0), 1);
+    EXPECT_THROW(ring.at(1), std::out_of_range);
+}
+
+// Elements whose move may throw are relocated by copy, so a failing copy
+// must leave the ring exactly as it was: same buffer, same wrapped layout.
+using ThrowingRing = RingVector<ThrowingMoveTracked, CountingAllocator<ThrowingMoveTracked>>;
+
+// A full ring of 8 whose first element is stored in slot 5.
+static ThrowingRing make_wrapped_ring() {
+    ThrowingRing ring;
+    for (int i = 0; i < 8; ++i) {
+        ring.emplace_back(i);
+    }
+    for (int i = 0; i < 5; ++i) {
+        ring.pop_front();
+        ring.emplace_back(i + 8);
+    }
+    return ring;
+}
+
+static void expect_ring_unchanged(const ThrowingRing& ring, const ThrowingMoveTracked* front) {
+    ASSERT_EQ(ring.size(), 8);
+    EXPECT_EQ(ring.capacity(), 8);
+    EXPECT_EQ(&ring.front(), front);
+    for (size_t i = 0; i < 8; ++i) {
+        ASSERT_EQ(ring[i].value, static_cast<int>(i + 5));
+    }
+    EXPECT_EQ(operation_counts().live_elements(), 0);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+}
+
+TEST(RingVector, GrowthExceptionSafety) {
+    ThrowingRing ring = make_wrapped_ring();
+    const ThrowingMoveTracked* front = &ring.front();
+
+    ThrowingMoveTracked extra(13);
+    for (size_t failing_copy = 0; failing_copy <= 8; ++failing_copy) {
+        reset_operation_counts();
+        operation_counts().copies_until_failure = failing_copy;
+        EXPECT_THROW(ring.push_back(extra), CopyFailure);
+        expect_ring_unchanged(ring, front);
+    }
+
+    reset_operation_counts();
+    operation_counts().copies_until_failure = 3;
+    EXPECT_THROW(ring.emplace_back(13), CopyFailure);
+    // the element constructed in the new buffer was destroyed with it
+    EXPECT_EQ(operation_counts().constructions, 1);
+    expect_ring_unchanged(ring, front);
+
+    reset_operation_counts();
+    operation_counts().copies_until_failure = 4;
+    EXPECT_THROW(ring.reserve(20), CopyFailure);
+    expect_ring_unchanged(ring, front);
+
+    for (int i = 0; i < 4; ++i) {
+        ring.pop_back();
+    }
+    reset_operation_counts();
+    operation_counts().copies_until_failure = 2;
+    EXPECT_THROW(ring.shrink_to_fit(), CopyFailure);
+    EXPECT_EQ(ring.size(), 4);
+    EXPECT_EQ(&ring.front(), front);
+    EXPECT_EQ(operation_counts().live_elements(), 0);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+    for (int i = 9; i < 13; ++i) {
+        ring.emplace_back(i);
+    }
+
+    reset_operation_counts();
+    ring.emplace_back(13);
+    EXPECT_EQ(ring.capacity(), 16);
+    EXPECT_EQ(operation_counts().copies, 8);
+    EXPECT_EQ(operation_counts().live_elements(), 1);
+    for (size_t i = 0; i < 9; ++i) {
+        ASSERT_EQ(ring[i].value, static_cast<int>(i + 5));
+    }
+}
+
+TEST(RingVector, CopyExceptionSafety) {
+    ThrowingRing ring = make_wrapped_ring();
+    const ThrowingMoveTracked* front = &ring.front();
+
+    for (size_t failing_copy = 0; failing_copy < 8; ++failing_copy) {
+        reset_operation_counts();
+        operation_counts().copies_until_failure = failing_copy;
+        EXPECT_THROW(ThrowingRing copy(ring), CopyFailure);
+        expect_ring_unchanged(ring, front);
+    }
+
+    ThrowingRing target;
+    target.emplace_back(-1);
+    const ThrowingMoveTracked* target_front = &target.front();
+    reset_operation_counts();
+    operation_counts().copies_until_failure = 5;
+    EXPECT_THROW(target = ring, CopyFailure);
+    ASSERT_EQ(target.size(), 1);
+    EXPECT_EQ(&target.front(), target_front);
+    EXPECT_EQ(target.front().value, -1);
+    EXPECT_EQ(operation_counts().live_elements(), 0);
+    EXPECT_EQ(operation_counts().allocations, operation_counts().deallocations);
+
+    operation_counts().copies_until_failure = static_cast<size_t>(-1);
+    target = ring;
+    ASSERT_EQ(target.size(), 8);
+    for (size_t i = 0; i < 8; ++i) {
+        ASSERT_EQ(target[i].value, static_cast<int>(i + 5));
+    }
+
+    // a target with room for the copy reuses its buffer
+    const ThrowingMoveTracked* buffer = &target.front();
+    reset_operation_counts();
+    target = ring;
+    EXPECT_EQ(operation_counts().allocations, 0);
+    EXPECT_EQ(operation_counts().copies, 8);
+    ASSERT_EQ(target.size(), 8);
+    EXPECT_EQ(&target.front(), buffer);
+    for (size_t i = 0; i < 8; ++i) {
+        ASSERT_EQ(target[i].value, static_cast<int>(i + 5));
+    }
+
+    // and then keeps only the elements copied before a failure
+    reset_operation_counts();
+    operation_counts().copies_until_failure = 3;
+    EXPECT_THROW(target = ring, CopyFailure);
+    EXPECT_EQ(operation_counts().allocations, 0);
+    ASSERT_EQ(target.size(), 3);
+    EXPECT_EQ(target.capacity(), 8);
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(target[i].value, static_cast<int>(i + 5));
+    }
+}
+
+TEST(SpscRingVector, Bounded) {
+    SpscRingVector<std::string> queue(3);
+    EXPECT_EQ(queue.capacity(), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_push(std::to_string(i)));
+    }
+    EXPECT_FALSE(queue.try_push("full"));
+    EXPECT_EQ(queue.size(), 4);
+
+    std::string value;
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, "0");
+    EXPECT_TRUE(queue.try_emplace(3, 'a'));
+    for (const char* expected: {"1", "2", "3", "aaa"}) {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+    EXPECT_TRUE(queue.empty());
+
+    // elements left in the queue are destroyed with it
+    queue.try_push(std::string(100, 'z'));
+}
+
+TEST(SpscRingVector, ProducerConsumer) {
+    const int count = 200000;
+    SpscRingVector<int> queue(256);
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            while (!queue.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    long long sum = 0;
+    int expected = 0;
+    while (expected < count) {
+        int value;
+        if (queue.try_pop(value)) {
+            ASSERT_EQ(value, expected);
+            sum += value;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_EQ(sum, static_cast<long long>(count) * (count - 1) / 2);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "../SlotMap.h"
+#include <map>
+#include <random>
+#include <string>
+
+TEST(SlotMap, InsertEraseGet) {
+    SlotMap<std::string> map;
+    SlotHandle a = map.insert("a");
+    SlotHandle b = map.emplace(3, 'b');
+    SlotHandle c = map.insert(std::string("c"));
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.at(b), "bbb");
+
+    // erasing the first value moves the last one into its place
+    EXPECT_TRUE(map.erase(a));
+    EXPECT_FALSE(map.erase(a));
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.data()[0], "c");
+    EXPECT_EQ(*map.get(c), "c");
+    EXPECT_EQ(map.at(b), "bbb");
+
+    EXPECT_FALSE(map.contains(a));
+    EXPECT_EQ(map.get(a), nullptr);
+    EXPECT_THROW(map.at(a), std::out_of_range);
+}
+
+TEST(SlotMap, StaleHandlesAfterReuse) {
+    SlotMap<int> map;
+    SlotHandle first = map.insert(1);
+    map.erase(first);
+
+    SlotHandle second = map.insert(2);
+    EXPECT_EQ(second.index, first.index);
+    EXPECT_NE(second, first);
+    EXPECT_FALSE(map.contains(first));
+    EXPECT_EQ(map.at(second), 2);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(second));
+    SlotHandle third = map.insert(3);
+    EXPECT_EQ(third.index, second.index);
+    EXPECT_FALSE(map.contains(second));
+
+    EXPECT_FALSE(map.contains(SlotHandle{100, 1}));
+    EXPECT_FALSE(map.contains(SlotHandle{third.index, third.generation + 1}));
+}
+
+TEST(SlotMap, MatchesMap) {
+    std::mt19937 generator(4);
+    SlotMap<int> map;
+    std::map<int, SlotHandle> expected;
+    std::vector<SlotHandle> erased;
+
+    for (int step = 0; step < 20000; ++step) {
+        if (generator() % 3 != 0 || expected.empty()) {
+            expected[step] = map.insert(step);
+        } else {
+            auto it = expected.begin();
+            std::advance(it, generator() % expected.size());
+            ASSERT_TRUE(map.erase(it->second));
+            erased.push_back(it->second);
+            expected.erase(it);
+        }
+    }
+
+    ASSERT_EQ(map.size(), expected.size());
+    for (const auto& entry: expected) {
+        ASSERT_EQ(map.at(entry.second), entry.first);
+    }
+    for (SlotHandle handle: erased) {
+        ASSERT_FALSE(map.contains(handle));
+    }
+
+    // dense iteration visits every value once, and handle_of() maps back to it
+    long long sum = 0, expected_sum = 0;
+    for (int value: map) {
+        sum += value;
+    }
+    for (const auto& entry: expected) {
+        expected_sum += entry.first;
+    }
+    EXPECT_EQ(sum, expected_sum);
+    for (size_t i = 0; i < map.size(); ++i) {
+        ASSERT_EQ(expected.at(map.data()[i]), map.handle_of(i));
+    }
+}
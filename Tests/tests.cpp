@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../Vector.h"
+#include "../SlackAllocator.h"
 #include <vector>
 
 using testing::Eq;
@@ -317,3 +318,101 @@ TEST(Vector, ConstIterator) {
     Vector<int>::ConstIterator iter = a.cbegin();
     ASSERT_EQ(*iter, 1);
 }
+
+template <class T>
+struct PaddedAllocator: std::allocator<T> {
+    static const size_t padding = 3;
+
+    template <class U>
+    struct rebind {
+        using other = PaddedAllocator<U>;
+    };
+
+    AllocationResult<T*> allocate_at_least(size_t count) {
+        return {this->allocate(count + padding), count + padding};
+    }
+};
+
+TEST(Vector, AllocateAtLeast) {
+    Vector<int, PaddedAllocator<int>> a;
+
+    a.push_back(1);
+    EXPECT_EQ(a.capacity(), 4);
+
+    for (int i = 2; i <= 5; ++i) {
+        a.push_back(i);
+    }
+    ASSERT_EQ(a.size(), 5);
+    EXPECT_EQ(a.capacity(), 11);
+
+    a.reserve(20);
+    EXPECT_EQ(a.capacity(), 23);
+
+    a.shrink_to_fit();
+    EXPECT_EQ(a.capacity(), 8);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(a[i], i + 1);
+    }
+
+    Vector<int, PaddedAllocator<int>> b(a);
+    EXPECT_EQ(b.size(), 5);
+    EXPECT_GE(b.capacity(), 5);
+    ASSERT_EQ(a, b);
+}
+
+TEST(Vector, SlackAllocator) {
+    Vector<int, SlackAllocator<int>> a;
+    vector<int> b;
+
+    size_t reallocations = 0;
+    for (int i = 0; i < 1000; ++i) {
+        size_t old_capacity = a.capacity();
+        a.push_back(i);
+        b.push_back(i);
+        reallocations += (a.capacity() != old_capacity);
+        ASSERT_GE(a.capacity(), a.size());
+#if defined(__GLIBC__)
+        ASSERT_EQ(a.capacity(), malloc_usable_size(a.data()) / sizeof(int));
+#endif
+    }
+#if !defined(__SANITIZE_ADDRESS__)
+    // plain doubling takes 11; AddressSanitizer's malloc has no slack
+    EXPECT_LT(reallocations, 11);
+#endif
+    for (size_t i = 0; i < b.size(); ++i) {
+        ASSERT_EQ(a[i], b[i]);
+    }
+
+    while (a.size() > 1) {
+        a.pop_back();
+    }
+    ASSERT_EQ(a.front(), 0);
+    ASSERT_GE(a.capacity(), 1);
+}
+
+TEST(Vector, ReserveBackCommit) {
+    Vector<int> a;
+    a.push_back(1);
+
+    int* spare = a.reserve_back(10);
+    EXPECT_EQ(spare, a.data() + 1);
+    EXPECT_GE(a.capacity(), 11);
+    for (int i = 0; i < 10; ++i) {
+        spare[i] = i + 2;
+    }
+    a.commit(4);
+    ASSERT_EQ(a.size(), 5);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(a[i], i + 1);
+    }
+
+    // storage already reserved is handed out again without reallocating
+    size_t capacity = a.capacity();
+    EXPECT_EQ(a.reserve_back(2), a.data() + 5);
+    EXPECT_EQ(a.capacity(), capacity);
+    EXPECT_THROW(a.commit(capacity), std::logic_error);
+
+    // growth stays geometric
+    a.reserve_back(capacity - 4);
+    EXPECT_GE(a.capacity(), 2 * capacity);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "../VectorExpression.h"
+#include <algorithm>
+#include <vector>
+
+using std::vector;
+
+static Vector<float> make_vector(const vector<float>& values) {
+    Vector<float> result;
+    for (float value: values) {
+        result.push_back(value);
+    }
+    return result;
+}
+
+TEST(VectorExpression, Arithmetic) {
+    Vector<float> a = make_vector({1, 2, 3, 4});
+    Vector<float> b = make_vector({5, 6, 7, 8});
+    Vector<float> c = make_vector({2, 2, 0.5f, -1});
+
+    Vector<float> r = evaluate(a + b * c);
+    ASSERT_EQ(r.size(), 4);
+    EXPECT_EQ(r[0], 11);
+    EXPECT_EQ(r[1], 14);
+    EXPECT_EQ(r[2], 6.5f);
+    EXPECT_EQ(r[3], -4);
+
+    r = evaluate((a - b) / c);
+    EXPECT_EQ(r[0], -2);
+    EXPECT_EQ(r[2], -8);
+
+    r = evaluate(-a);
+    EXPECT_EQ(r[3], -4);
+    ASSERT_EQ(a[3], 4);
+}
+
+TEST(VectorExpression, ScalarBroadcast) {
+    Vector<double> x(5, 2.0), y(5, 1.0);
+
+    // axpy in place: y is read and written by the same fused loop
+    assign(y, 3.0 * x + y);
+    for (size_t i = 0; i < y.size(); ++i) {
+        ASSERT_EQ(y[i], 7.0);
+    }
+
+    assign(y, y / 7 - 1);
+    for (size_t i = 0; i < y.size(); ++i) {
+        ASSERT_EQ(y[i], 0.0);
+    }
+}
+
+TEST(VectorExpression, MinMaxClamp) {
+    Vector<float> a = make_vector({-2, 0.25f, 0.75f, 3});
+    Vector<float> b = make_vector({0, 0, 1, 1});
+
+    Vector<float> r = evaluate(elementwise::min(a, b));
+    EXPECT_EQ(r[0], -2);
+    EXPECT_EQ(r[1], 0);
+    EXPECT_EQ(r[3], 1);
+
+    r = evaluate(elementwise::max(a, 0.5f));
+    EXPECT_EQ(r[0], 0.5f);
+    EXPECT_EQ(r[2], 0.75f);
+
+    r = evaluate(elementwise::clamp(a, 0.0f, 1.0f));
+    EXPECT_EQ(r[0], 0);
+    EXPECT_EQ(r[1], 0.25f);
+    EXPECT_EQ(r[2], 0.75f);
+    EXPECT_EQ(r[3], 1);
+
+    // Vector bounds must clamp element by element, not pick a bound by std::min
+    Vector<float> low(4, 0.0f), high(4, 1.0f);
+    r = evaluate(elementwise::clamp(a, low, high));
+    EXPECT_EQ(r[0], 0);
+    EXPECT_EQ(r[1], 0.25f);
+    EXPECT_EQ(r[2], 0.75f);
+    EXPECT_EQ(r[3], 1);
+
+    // lexicographic comparison of whole Vectors is unaffected
+    EXPECT_FALSE(b < a);
+    EXPECT_TRUE(a < b);
+}
+
+TEST(VectorExpression, ComparisonMasks) {
+    Vector<int> a(4), b(4, 1);
+    for (int i = 0; i < 4; ++i) {
+        a[i] = i;
+    }
+
+    Vector<bool> mask = evaluate(elementwise::greater(a, b));
+    ASSERT_EQ(mask.size(), 4);
+    EXPECT_FALSE(mask[0]);
+    EXPECT_FALSE(mask[1]);
+    EXPECT_TRUE(mask[2]);
+    EXPECT_TRUE(mask[3]);
+
+    mask = evaluate(elementwise::equal(a, 1));
+    EXPECT_TRUE(mask[1]);
+    EXPECT_FALSE(mask[2]);
+
+    mask = evaluate(elementwise::less_equal(a * 2, b + 1));
+    EXPECT_TRUE(mask[0]);
+    EXPECT_TRUE(mask[1]);
+    EXPECT_FALSE(mask[2]);
+}
+
+TEST(VectorExpression, Destination) {
+    Vector<int> a(1000, 3), b(1000, 4);
+    Vector<int> r(10, 0);
+
+    assign(r, a * b);
+    ASSERT_EQ(r.size(), 1000);
+    ASSERT_TRUE(std::all_of(r.begin(), r.end(), [](int value) { return value == 12; }));
+
+    Vector<int> large(1000, 0);
+    const int* storage = large.data();
+    assign(large, a + b);
+    EXPECT_EQ(large.data(), storage);
+    EXPECT_EQ(large[999], 7);
+}
+
+TEST(VectorExpression, SizeMismatch) {
+    Vector<int> a(3), b(4);
+    ASSERT_THROW(a + b, std::invalid_argument);
+    ASSERT_THROW(evaluate(a * 2 - b), std::invalid_argument);
+    ASSERT_NO_THROW(evaluate(a * 2 - 1));
+}
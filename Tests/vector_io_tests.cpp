@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "../VectorIO.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static std::string write_temp_file(const void* data, size_t size) {
+    char path[] = "/tmp/vector_io_XXXXXX";
+    int fd = mkstemp(path);
+    EXPECT_GE(fd, 0);
+    EXPECT_EQ(write(fd, data, size), static_cast<ssize_t>(size));
+    close(fd);
+    return path;
+}
+
+TEST(VectorIO, AppendFromFile) {
+    Vector<uint64_t> expected;
+    for (uint64_t i = 0; i < 100000; ++i) {
+        expected.push_back(i * i);
+    }
+    std::string path = write_temp_file(expected.data(), expected.size() * sizeof(uint64_t));
+
+    Vector<uint64_t> values;
+    values.push_back(42);
+    int fd = open(path.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(append_from_fd(values, fd), expected.size());
+    ASSERT_EQ(values.size(), expected.size() + 1);
+    EXPECT_EQ(values[0], 42);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(values[i + 1], expected[i]);
+    }
+
+    // reading from an offset, bounded by max_bytes
+    Vector<uint64_t> middle;
+    ASSERT_EQ(lseek(fd, 8 * 1000, SEEK_SET), 8 * 1000);
+    EXPECT_EQ(append_from_fd(middle, fd, 8 * 10), 10);
+    ASSERT_EQ(middle.size(), 10);
+    EXPECT_EQ(middle[0], expected[1000]);
+    EXPECT_EQ(middle[9], expected[1009]);
+    close(fd);
+    unlink(path.c_str());
+}
+
+TEST(VectorIO, PartialReadsFromPipe) {
+    int pipe_fds[2];
+    ASSERT_EQ(pipe(pipe_fds), 0);
+
+    // The writer cuts the stream at sizes unrelated to the element size.
+    const uint32_t count = 50000;
+    std::thread writer([&] {
+        Vector<uint32_t> data;
+        for (uint32_t i = 0; i < count; ++i) {
+            data.push_back(i ^ 0x5a5a5a5a);
+        }
+        const char* bytes = reinterpret_cast<const char*>(data.data());
+        size_t left = count * sizeof(uint32_t);
+        for (size_t step = 1; left > 0; step = step * 7 % 1013 + 1) {
+            size_t chunk = std::min(step, left);
+            ASSERT_EQ(write(pipe_fds[1], bytes, chunk), static_cast<ssize_t>(chunk));
+            bytes += chunk;
+            left -= chunk;
+        }
+        close(pipe_fds[1]);
+    });
+
+    Vector<uint32_t> values;
+    EXPECT_EQ(append_from_fd(values, pipe_fds[0]), count);
+    writer.join();
+    close(pipe_fds[0]);
+    ASSERT_EQ(values.size(), count);
+    for (uint32_t i = 0; i < count; ++i) {
+        ASSERT_EQ(values[i], i ^ 0x5a5a5a5a);
+    }
+}
+
+TEST(VectorIO, Errors) {
+    const char bytes[] = "0123456789";
+    std::string path = write_temp_file(bytes, 10);
+    int fd = open(path.c_str(), O_RDONLY);
+    Vector<uint32_t> values;
+    EXPECT_THROW(append_from_fd(values, fd), std::runtime_error);
+    EXPECT_EQ(values.size(), 2);
+    close(fd);
+    unlink(path.c_str());
+
+    EXPECT_THROW(append_from_fd(values, -1), std::system_error);
+    try {
+        append_from_fd(values, -1);
+    } catch (const std::system_error& error) {
+        EXPECT_EQ(error.code().value(), EBADF);
+    }
+}
+
+TEST(VectorIO, AppendFromIstream) {
+    Vector<int16_t> expected;
+    for (int i = 0; i < 70000; ++i) {
+        expected.push_back(static_cast<int16_t>(i * 31));
+    }
+    std::istringstream in(std::string(reinterpret_cast<const char*>(expected.data()),
+                                      expected.size() * sizeof(int16_t)));
+
+    Vector<int16_t> values;
+    EXPECT_EQ(append_from_istream(values, in, 2 * 5), 5);
+    EXPECT_EQ(append_from_istream(values, in), expected.size() - 5);
+    EXPECT_TRUE(values == expected);
+    EXPECT_EQ(append_from_istream(values, in), 0);
+
+    std::istringstream odd("abc");
+    EXPECT_THROW(append_from_istream(values, odd), std::runtime_error);
+    EXPECT_EQ(values.size(), expected.size() + 1);
+}
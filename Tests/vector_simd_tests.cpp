@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "../VectorSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+static vector<SimdLevel> available_levels() {
+    vector<SimdLevel> levels;
+    for (int level = 0; level <= static_cast<int>(simd::supported_level()); ++level) {
+        levels.push_back(static_cast<SimdLevel>(level));
+    }
+    return levels;
+}
+
+template <class T>
+static Vector<T> random_vector(size_t size, int range, std::mt19937& generator) {
+    std::uniform_int_distribution<int> distribution(-range, range);
+    Vector<T> result;
+    for (size_t i = 0; i < size; ++i) {
+        result.push_back(static_cast<T>(distribution(generator)));
+    }
+    return result;
+}
+
+template <class T>
+static void check_against_std() {
+    std::mt19937 generator(42);
+    const T* none = nullptr;
+
+    for (SimdLevel level: available_levels()) {
+        simd::set_level(level);
+        for (size_t size: {0, 1, 3, 7, 8, 15, 16, 17, 31, 33, 64, 100, 129, 1000, 4099}) {
+            Vector<T> v = random_vector<T>(size, 20, generator);
+            const T* first = v.data();
+            const T* last = v.data() + v.size();
+            SCOPED_TRACE(testing::Message() << "level " << static_cast<int>(level) << ", size " << size);
+
+            for (T value: {T(0), T(5), T(19), T(100)}) {
+                ASSERT_EQ(simd::find(v, value).operator->(), std::find(first, last, value));
+                ASSERT_EQ(simd::count(v, value), std::count(first, last, value));
+                ASSERT_EQ(simd::contains(v, value), std::find(first, last, value) != last);
+            }
+
+            ASSERT_EQ(simd::min_element(v).operator->(), size ? std::min_element(first, last) : none);
+            ASSERT_EQ(simd::max_element(v).operator->(), size ? std::max_element(first, last) : none);
+            auto bounds = simd::minmax(v);
+            auto expected = std::minmax_element(first, last);
+            ASSERT_EQ(bounds.first.operator->(), size ? expected.first : none);
+            ASSERT_EQ(bounds.second.operator->(), size ? expected.second : none);
+
+            ASSERT_EQ(simd::sum(v), std::accumulate(first, last, T()));
+            ASSERT_EQ(simd::dot(v, v), std::inner_product(first, last, first, T()));
+        }
+    }
+    simd::set_level(simd::supported_level());
+}
+
+TEST(VectorSimd, Int32) {
+    check_against_std<int32_t>();
+}
+
+TEST(VectorSimd, UInt32) {
+    check_against_std<uint32_t>();
+}
+
+TEST(VectorSimd, Int64) {
+    check_against_std<int64_t>();
+}
+
+// Small integers keep floating-point sums exact, so any summation order matches.
+TEST(VectorSimd, Float) {
+    check_against_std<float>();
+}
+
+TEST(VectorSimd, Double) {
+    check_against_std<double>();
+}
+
+TEST(VectorSimd, NonSimdElement) {
+    check_against_std<int16_t>();
+}
+
+TEST(VectorSimd, IteratorRange) {
+    Vector<int> v(100, 1);
+    v[10] = 7;
+    v[90] = 7;
+    v[50] = -3;
+
+    auto first = v.cbegin() + 20;
+    auto last = v.cend();
+    ASSERT_EQ(simd::find(first, last, 7), v.cbegin() + 90);
+    ASSERT_EQ(simd::count(first, last, 7), 1);
+    ASSERT_FALSE(simd::contains(first, first + 10, 7));
+    ASSERT_EQ(simd::min_element(first, last), v.cbegin() + 50);
+    ASSERT_EQ(simd::sum(first, last), 80 + 6 - 4);
+
+    Vector<int>::Iterator mutable_iter = simd::max_element(v.begin(), v.end());
+    *mutable_iter = 0;
+    ASSERT_EQ(v[10], 0);
+}
+
+TEST(VectorSimd, FloatEdgeCases) {
+    for (SimdLevel level: available_levels()) {
+        simd::set_level(level);
+
+        Vector<float> v(40, 1.0f);
+        v[3] = -0.0f;
+        v[30] = 0.0f;
+        v[35] = std::numeric_limits<float>::quiet_NaN();
+        const float* first = v.data();
+        const float* last = v.data() + v.size();
+
+        ASSERT_EQ(simd::min_element(v).operator->(), std::min_element(first, last));
+        ASSERT_EQ(simd::max_element(v).operator->(), std::max_element(first, last));
+        ASSERT_EQ(simd::find(v, 0.0f).operator->(), first + 3);
+        ASSERT_EQ(simd::count(v, std::numeric_limits<float>::quiet_NaN()), 0);
+        ASSERT_TRUE(std::isnan(simd::sum(v)));
+
+        v[35] = 2.5f;
+        ASSERT_EQ(simd::min_element(v).operator->(), first + 3);
+        ASSERT_EQ(simd::max_element(v).operator->(), first + 35);
+        ASSERT_FLOAT_EQ(simd::sum(v), 37.0f + 2.5f);
+        ASSERT_FLOAT_EQ(simd::dot(v, v), 37.0f + 6.25f);
+    }
+    simd::set_level(simd::supported_level());
+}
+
+TEST(VectorSimd, DotSizeMismatch) {
+    Vector<float> a(3), b(4);
+    ASSERT_THROW(simd::dot(a, b), std::invalid_argument);
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include "../VectorSort.h"
+#include "instrumented.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <class T>
+static void check_radix(const std::vector<T>& input) {
+    Vector<T> values;
+    for (T value: input) {
+        values.push_back(value);
+    }
+    std::vector<T> expected(input);
+    std::sort(expected.begin(), expected.end());
+
+    sorting::sort(values);
+    ASSERT_EQ(values.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(values[i], expected[i]) << "at " << i;
+    }
+}
+
+TEST(VectorSort, RadixIntegral) {
+    std::mt19937_64 generator(5);
+    for (size_t size: {0, 1, 2, 100, 5000}) {
+        std::vector<uint32_t> small;
+        std::vector<int64_t> wide;
+        std::vector<int8_t> bytes;
+        for (size_t i = 0; i < size; ++i) {
+            small.push_back(static_cast<uint32_t>(generator() % 1000));
+            wide.push_back(static_cast<int64_t>(generator()));
+            bytes.push_back(static_cast<int8_t>(generator()));
+        }
+        wide.push_back(std::numeric_limits<int64_t>::min());
+        wide.push_back(std::numeric_limits<int64_t>::max());
+        check_radix(small);
+        check_radix(wide);
+        check_radix(bytes);
+    }
+}
+
+TEST(VectorSort, RadixFloating) {
+    std::mt19937 generator(6);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    std::vector<float> floats = {0.0f, std::numeric_limits<float>::infinity(),
+                                 -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::denorm_min()};
+    std::vector<double> doubles = {-0.5, 0.5, std::numeric_limits<double>::lowest()};
+    for (int i = 0; i < 3000; ++i) {
+        floats.push_back(static_cast<float>(distribution(generator)));
+        doubles.push_back(distribution(generator));
+    }
+    check_radix(floats);
+    check_radix(doubles);
+}
+
+struct Record {
+    uint16_t key;
+    int order;
+};
+
+TEST(VectorSort, RadixByKeyIsStable) {
+    using RecordAllocator = CountingAllocator<Record>;
+    Vector<Record, RecordAllocator> records;
+    std::mt19937 generator(7);
+    for (int i = 0; i < 10000; ++i) {
+        records.push_back(Record{static_cast<uint16_t>(generator() % 300), i});
+    }
+
+    reset_operation_counts();
+    sorting::radix_sort(records, [](const Record& record) noexcept { return record.key; });
+    EXPECT_EQ(operation_counts().allocations, 1);
+    EXPECT_EQ(operation_counts().allocated_elements, 10000);
+    EXPECT_EQ(operation_counts().deallocations, 1);
+
+    for (size_t i = 1; i < records.size(); ++i) {
+        ASSERT_TRUE(records[i - 1].key < records[i].key ||
+                    (records[i - 1].key == records[i].key && records[i - 1].order < records[i].order));
+    }
+}
+
+TEST(VectorSort, RadixKeyMayThrow) {
+    Vector<Tracked> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(Tracked((i * 7919) % 1000));
+    }
+
+    // a throwing key leaves the elements untouched
+    size_t calls = 0;
+    auto failing_key = [&calls](const Tracked& element) {
+        if (++calls == 500) {
+            throw std::runtime_error("key");
+        }
+        return element.value;
+    };
+    reset_operation_counts();
+    EXPECT_THROW(sorting::radix_sort(values, failing_key), std::runtime_error);
+    EXPECT_EQ(operation_counts().moves, 0);
+    ASSERT_EQ(values.size(), 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(values[i].value, (i * 7919) % 1000);
+    }
+
+    // a key that is not noexcept is called once per element
+    calls = 0;
+    sorting::radix_sort(values, [&calls](const Tracked& element) {
+        ++calls;
+        return element.value;
+    });
+    EXPECT_EQ(calls, 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(values[i].value, i);
+    }
+    EXPECT_EQ(operation_counts().moves, operation_counts().destructions);
+}
+
+TEST(VectorSort, ParallelMatchesStd) {
+    std::mt19937 generator(8);
+    for (size_t threads: {1, 2, 3, 8}) {
+        for (size_t size: {10, 40000, 100001}) {
+            Vector<int> values;
+            std::vector<int> expected;
+            for (size_t i = 0; i < size; ++i) {
+                int value = static_cast<int>(generator() % 50000);
+                values.push_back(value);
+                expected.push_back(value);
+            }
+            std::sort(expected.begin(), expected.end(), std::greater<int>());
+
+            sorting::sort(values, std::greater<int>(), threads);
+            ASSERT_EQ(values.size(), size);
+            for (size_t i = 0; i < size; ++i) {
+                ASSERT_EQ(values[i], expected[i]) << "threads " << threads << ", size " << size << ", at " << i;
+            }
+        }
+    }
+}
+
+TEST(VectorSort, ParallelStable) {
+    Vector<Record> records;
+    std::mt19937 generator(9);
+    for (int i = 0; i < 100000; ++i) {
+        records.push_back(Record{static_cast<uint16_t>(generator() % 100), i});
+    }
+    sorting::stable_sort(records, [](const Record& lhs, const Record& rhs) { return lhs.key < rhs.key; }, 4);
+    for (size_t i = 1; i < records.size(); ++i) {
+        ASSERT_TRUE(records[i - 1].key < records[i].key ||
+                    (records[i - 1].key == records[i].key && records[i - 1].order < records[i].order));
+    }
+}
+
+TEST(VectorSort, GenericElements) {
+    Vector<std::string> words;
+    for (int i = 0; i < 70000; ++i) {
+        words.push_back(std::to_string((i * 7919) % 70000));
+    }
+    sorting::sort(words);
+    EXPECT_TRUE(std::is_sorted(words.data(), words.data() + words.size()));
+
+    Vector<ThrowingMoveTracked> tracked;
+    for (int i = 0; i < 1000; ++i) {
+        tracked.emplace_back((i * 37) % 1000);
+    }
+    sorting::stable_sort(tracked);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(tracked[i].value, i);
+    }
+}
+
+TEST(VectorSort, ComparatorThrows) {
+    Vector<std::string> words;
+    for (int i = 0; i < 100000; ++i) {
+        words.push_back(std::to_string(i % 977) + "some padding to defeat the small string buffer");
+    }
+    std::atomic<size_t> calls{0};
+    auto comp = [&calls](const std::string& lhs, const std::string& rhs) {
+        if (++calls == 1500000) {
+            throw std::runtime_error("comparison failed");
+        }
+        return lhs < rhs;
+    };
+    EXPECT_THROW(sorting::sort(words, comp, 4), std::runtime_error);
+    EXPECT_EQ(words.size(), 100000);
+}
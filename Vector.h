@@ -2,12 +2,146 @@
 #define VECTOR_H
 
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 template <class T, class Alloc = std::allocator<T>>
 class Vector;
 
 
+// Allocators may report the real size of the block they hand out through
+// allocate_at_least(n), which returns {ptr, count} with count >= n.
+// Vector records count as its capacity, so allocator slack is not wasted.
+template <class Pointer>
+struct AllocationResult {
+    Pointer ptr;
+    size_t count;
+};
+
+template <class Alloc, class = void>
+struct HasAllocateAtLeast : std::false_type {};
+
+template <class Alloc>
+struct HasAllocateAtLeast<Alloc, decltype(void(std::declval<Alloc&>().allocate_at_least(size_t())))>
+        : std::true_type {};
+
+
+// Owns a buffer while a container fills it: unless released, destroys the
+// elements constructed in it and returns it to the allocator. Vector and
+// RingVector build every new buffer through one, so a throwing element
+// constructor leaves the container unchanged.
+template <class T, class Alloc>
+class StorageGuard {
+public:
+    StorageGuard(Alloc& , T* , size_t );
+    StorageGuard(const StorageGuard&) = delete;
+    StorageGuard& operator=(const StorageGuard&) = delete;
+    ~StorageGuard();
+
+    // Relocates [first, first + first_count) and then [second, second + second_count)
+    // to arr + constructed: by move when that cannot throw, otherwise by copy
+    // (by move for move-only types), destroying the old elements only after
+    // every copy has succeeded.
+    void relocate(T* first, size_t first_count, T* second = nullptr, size_t second_count = 0);
+    T* release() noexcept;
+
+    T* arr;
+    size_t capacity;
+    size_t constructed = 0;   // elements [0, constructed)
+    T* extra = nullptr;       // one more element outside that range
+
+private:
+    using traits = std::allocator_traits<Alloc>;
+    // Trivially copyable elements move as raw bytes, unless the allocator customizes construction.
+    using BulkRelocatable = std::integral_constant<bool,
+            std::is_trivially_copyable<T>::value && std::is_same<Alloc, std::allocator<T>>::value>;
+
+    void move_from(T* from, size_t count, std::true_type) noexcept;
+    void move_from(T* from, size_t count, std::false_type) noexcept;
+    void relocate(T* first, size_t first_count, T* second, size_t second_count, std::true_type) noexcept;
+    void relocate(T* first, size_t first_count, T* second, size_t second_count, std::false_type);
+
+    Alloc& alloc_;
+};
+
+template<class T, class Alloc>
+StorageGuard<T, Alloc>::StorageGuard(Alloc& alloc, T* init_arr, size_t init_capacity) :
+    arr(init_arr),
+    capacity(init_capacity),
+    alloc_(alloc) {}
+
+template<class T, class Alloc>
+StorageGuard<T, Alloc>::~StorageGuard() {
+    if (arr == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < constructed; ++i) {
+        traits::destroy(alloc_, arr + i);
+    }
+    if (extra != nullptr) {
+        traits::destroy(alloc_, extra);
+    }
+    traits::deallocate(alloc_, arr, capacity);
+}
+
+template<class T, class Alloc>
+void StorageGuard<T, Alloc>::relocate(T* first, size_t first_count, T* second, size_t second_count) {
+    relocate(first, first_count, second, second_count, std::is_nothrow_move_constructible<T>());
+}
+
+template<class T, class Alloc>
+T* StorageGuard<T, Alloc>::release() noexcept {
+    T* result = arr;
+    arr = nullptr;
+    return result;
+}
+
+template<class T, class Alloc>
+void StorageGuard<T, Alloc>::move_from(T* from, size_t count, std::true_type) noexcept {
+    if (count != 0) {
+        std::memcpy(static_cast<void*>(arr + constructed), static_cast<const void*>(from), count * sizeof(T));
+    }
+    constructed += count;
+}
+
+template<class T, class Alloc>
+void StorageGuard<T, Alloc>::move_from(T* from, size_t count, std::false_type) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        traits::construct(alloc_, arr + constructed + i, std::move(from[i]));
+        traits::destroy(alloc_, from + i);
+    }
+    constructed += count;
+}
+
+template<class T, class Alloc>
+void StorageGuard<T, Alloc>::relocate(T* first, size_t first_count, T* second, size_t second_count,
+                                      std::true_type) noexcept {
+    move_from(first, first_count, BulkRelocatable());
+    move_from(second, second_count, BulkRelocatable());
+}
+
+template<class T, class Alloc>
+void StorageGuard<T, Alloc>::relocate(T* first, size_t first_count, T* second, size_t second_count,
+                                      std::false_type) {
+    for (size_t i = 0; i < first_count; ++i, ++constructed) {
+        traits::construct(alloc_, arr + constructed, std::move_if_noexcept(first[i]));
+    }
+    for (size_t i = 0; i < second_count; ++i, ++constructed) {
+        traits::construct(alloc_, arr + constructed, std::move_if_noexcept(second[i]));
+    }
+    for (size_t i = 0; i < first_count; ++i) {
+        traits::destroy(alloc_, first + i);
+    }
+    for (size_t i = 0; i < second_count; ++i) {
+        traits::destroy(alloc_, second + i);
+    }
+}
+
+
 // Arithmetic operations for Implementing Vector
 template <class T, class Alloc>
 bool operator==(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs) {
@@ -41,54 +175,55 @@ bool operator>=(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs) {
 
 
 // Arithmetic operations for Bidirectional Iterator
-template <class RandomIterator>
+// (restricted to iterator types, so they never compete with operators on other classes)
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 bool operator==(const RandomIterator& lhs, const RandomIterator& rhs) {
     return rhs.ptr_ == lhs.ptr_;
 }
 
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 bool operator!=(const RandomIterator& lhs, const RandomIterator& rhs) {
     return rhs.ptr_ != lhs.ptr_;
 }
 
 
 // Arithmetic operations for Random Access Iterator
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 RandomIterator operator+(const RandomIterator& iter, const int offset) {
     return RandomIterator(iter.ptr_ + offset);
 }
 
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 RandomIterator operator+(const int offset, const RandomIterator& iter) {
     return RandomIterator(iter.ptr + offset);
 }
 
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 RandomIterator operator-(const RandomIterator& iter, const int offset) {
     return RandomIterator(iter.ptr_ - offset);
 }
 
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 int operator-(const RandomIterator& lhs, const RandomIterator& rhs) {
     return (lhs.ptr_ - rhs.ptr_);
 }
 
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 bool operator<(const RandomIterator& lhs, const RandomIterator& rhs) {
     return lhs.ptr_ < rhs.ptr_;
 }
 
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 bool operator>(const RandomIterator& lhs, const RandomIterator& rhs) {
     return rhs < lhs;
 }
 
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 bool operator<=(const RandomIterator& lhs, const RandomIterator& rhs) {
     return lhs.ptr_ <= rhs.ptr_;
 }
 
-template <class RandomIterator>
+template <class RandomIterator, class = typename RandomIterator::iterator_category>
 bool operator>=(const RandomIterator& lhs, const RandomIterator& rhs) {
     return rhs <= lhs;
 }
@@ -126,6 +261,11 @@ public:
     void shrink_to_fit();
     void resize(size_t , const T& = T());
 
+    // reserve_back(n) returns uninitialized storage for n elements past the end;
+    // commit(k) appends the first k of them once the caller has constructed them.
+    T* reserve_back(size_t );
+    void commit(size_t );
+
     T& operator [](size_t );
     T& at(size_t );
     Iterator begin() noexcept;
@@ -147,6 +287,7 @@ public:
     bool empty() const noexcept;
     size_t capacity() const noexcept;
     size_t size() const noexcept;
+    Alloc get_allocator() const noexcept;
 
     int compare(const Vector&) const;
     friend bool operator == <T, Alloc>(const Vector&, const Vector&);
@@ -161,6 +302,8 @@ public:
     class BaseIterator: public std::iterator<std::random_access_iterator_tag,
                                              typename std::conditional<is_const, const T, T>::type> {
     public:
+        using container_type = Vector;
+
         BaseIterator() = default;
         BaseIterator(const BaseIterator&) = default;
         explicit BaseIterator(typename BaseIterator::pointer);
@@ -201,6 +344,17 @@ public:
 
 
 private:
+    using StorageGuard = ::StorageGuard<T, Alloc>;
+
+    T* allocate_at_least(size_t& count);
+    T* allocate_at_least(size_t& count, std::true_type);
+    T* allocate_at_least(size_t& count, std::false_type);
+
+    void replace_storage(StorageGuard& guard) noexcept;
+    template <class... Args>
+    void grow_and_emplace_back(Args&&... args);
+    void try_shrink(size_t new_capacity) noexcept;
+
     size_t size_ = 0u, capacity_ = 0;
     Alloc alloc_ = Alloc();
     T* arr_ = nullptr;
@@ -312,14 +466,17 @@ Vector<T, Alloc>::Vector(const Alloc &init_alloc) :
 
 template<class T, class Alloc>
 Vector<T, Alloc>::Vector(size_t init_size, const T& init_value, const Alloc& init_alloc) :
-    size_(init_size),
+    size_(0),
     capacity_(init_size),
     alloc_(init_alloc),
-    arr_(traits::allocate(alloc_, capacity_)) {
+    arr_(allocate_at_least(capacity_)) {
 
-    for (size_t i = 0; i < size_; ++i) {
-        traits::construct(alloc_, arr_ + i, init_value);
+    StorageGuard guard(alloc_, arr_, capacity_);
+    for (; guard.constructed < init_size; ++guard.constructed) {
+        traits::construct(alloc_, arr_ + guard.constructed, init_value);
     }
+    size_ = init_size;
+    guard.release();
 }
 
 template<class T, class Alloc>
@@ -341,14 +498,17 @@ void Vector<T, Alloc>::clear() {
 
 template<class T, class Alloc>
 Vector<T, Alloc>::Vector(const Vector& other_vector) :
-    size_(other_vector.size_),
-    capacity_(other_vector.capacity_),
+    size_(0),
+    capacity_(other_vector.size_),
     alloc_(traits::select_on_container_copy_construction(other_vector.alloc_)),
-    arr_(traits::allocate(alloc_, capacity_)) {
+    arr_(allocate_at_least(capacity_)) {
 
-    for (size_t i = 0; i < size_; ++i) {
-        traits::construct(alloc_, arr_ + i, other_vector.arr_[i]);
+    StorageGuard guard(alloc_, arr_, capacity_);
+    for (; guard.constructed < other_vector.size_; ++guard.constructed) {
+        traits::construct(alloc_, arr_ + guard.constructed, other_vector.arr_[guard.constructed]);
     }
+    size_ = other_vector.size_;
+    guard.release();
 }
 
 template<class T, class Alloc>
@@ -365,27 +525,41 @@ Vector<T, Alloc>::Vector(Vector&& other_vector) noexcept :
 template<class T, class Alloc>
 Vector<T, Alloc>& Vector<T, Alloc>::operator=(const Vector& other_vector) & {
     if (this != &other_vector) {
-        for (size_t i = 0; i < size_; ++i) {
-            traits::destroy(alloc_, arr_ + i);
-        }
         bool alloc_copy_req = traits::propagate_on_container_copy_assignment::value;
         bool realloc_req = (capacity_ < other_vector.size_) ||
                 (other_vector.size_ <= capacity_ / 4) || (alloc_copy_req && alloc_ != other_vector.alloc_);
 
         if (realloc_req) {
-            traits::deallocate(alloc_, arr_, capacity_);
-        }
-        if (alloc_copy_req) {
-            alloc_ = other_vector.alloc_;
-        }
-        if (realloc_req) {
-            capacity_ = other_vector.size_;
-            arr_ = traits::allocate(alloc_, capacity_);
-        }
+            // The copy is built in a new buffer first, so a throwing copy leaves the Vector unchanged.
+            Vector copy(alloc_copy_req ? other_vector.alloc_ : alloc_);
+            copy.reserve(other_vector.size_);
+            for (size_t i = 0; i < other_vector.size_; ++i) {
+                copy.push_back(other_vector[i]);
+            }
 
-        size_ = other_vector.size_;
-        for (size_t i = 0; i < size_; ++i) {
-            traits::construct(alloc_, arr_ + i, other_vector[i]);
+            this->clear();
+            if (alloc_copy_req) {
+                alloc_ = copy.alloc_;
+            }
+            size_ = copy.size_;
+            capacity_ = copy.capacity_;
+            arr_ = copy.arr_;
+            copy.size_ = copy.capacity_ = 0;
+            copy.arr_ = nullptr;
+        } else {
+            for (size_t i = 0; i < size_; ++i) {
+                traits::destroy(alloc_, arr_ + i);
+            }
+            size_ = 0;
+            if (alloc_copy_req) {
+                alloc_ = other_vector.alloc_;
+            }
+
+            // Copying into the existing buffer: a throwing copy leaves the elements copied so far.
+            while (size_ < other_vector.size_) {
+                traits::construct(alloc_, arr_ + size_, other_vector[size_]);
+                ++size_;
+            }
         }
     }
     return (*this);
@@ -398,14 +572,18 @@ Vector<T, Alloc>& Vector<T, Alloc>::operator=(Vector&& other_vector) & noexcept
             for (size_t i = 0; i < size_; ++i) {
                 traits::destroy(alloc_, arr_ + i);
             }
+            size_ = 0;
             if (capacity_ < other_vector.size_ || other_vector.size_ <= capacity_ / 4) {
                 traits::deallocate(alloc_, arr_, capacity_);
-                arr_ = traits::allocate(alloc_, other_vector.size_);
-                capacity_ = other_vector.size_;
+                arr_ = nullptr;
+                capacity_ = 0;
+                size_t new_capacity = other_vector.size_;
+                arr_ = allocate_at_least(new_capacity);
+                capacity_ = new_capacity;
             }
-            size_ = other_vector.size_;
-            for (size_t i = 0; i < size_; ++i) {
-                traits::construct(alloc_, arr_ + i, std::move_if_noexcept(other_vector[i]));
+            while (size_ < other_vector.size_) {
+                traits::construct(alloc_, arr_ + size_, std::move_if_noexcept(other_vector[size_]));
+                ++size_;
             }
             other_vector.clear();
         } else {
@@ -426,24 +604,63 @@ Vector<T, Alloc>& Vector<T, Alloc>::operator=(Vector&& other_vector) & noexcept
 
 
 
+template<class T, class Alloc>
+T* Vector<T, Alloc>::allocate_at_least(size_t& count) {
+    if (count == 0) {
+        return nullptr;
+    }
+    return allocate_at_least(count, HasAllocateAtLeast<Alloc>());
+}
+
+template<class T, class Alloc>
+T* Vector<T, Alloc>::allocate_at_least(size_t& count, std::true_type) {
+    auto result = alloc_.allocate_at_least(count);
+    assert(result.count >= count);
+    count = result.count;
+    return result.ptr;
+}
+
+template<class T, class Alloc>
+T* Vector<T, Alloc>::allocate_at_least(size_t& count, std::false_type) {
+    return traits::allocate(alloc_, count);
+}
+
+
+// Frees the old buffer, whose elements guard.relocate has destroyed, and
+// takes over the guarded one.
+template<class T, class Alloc>
+void Vector<T, Alloc>::replace_storage(StorageGuard& guard) noexcept {
+    if (arr_ != nullptr) {
+        traits::deallocate(alloc_, arr_, capacity_);
+    }
+    capacity_ = guard.capacity;
+    arr_ = guard.release();
+}
+
+
+// The new element is constructed before the old ones are relocated, so
+// arguments that refer into the Vector stay valid. If anything throws, the
+// guard frees the new buffer and the Vector is left unchanged.
+template<class T, class Alloc>
+template<class... Args>
+void Vector<T, Alloc>::grow_and_emplace_back(Args&&... args) {
+    assert(size_ == capacity_);
+    size_t new_capacity = capacity_ == 0 ? 1 : 2 * capacity_;
+    T* new_arr = allocate_at_least(new_capacity);
+    StorageGuard guard(alloc_, new_arr, new_capacity);
+    traits::construct(alloc_, new_arr + size_, std::forward<Args>(args)...);
+    guard.extra = new_arr + size_;
+    guard.relocate(arr_, size_);
+    replace_storage(guard);
+}
+
+// Growth lives in grow_and_emplace_back, so that the common case stays small
+// enough to be inlined into the caller's loop.
 #define pushBack(method_argument_transmission) { \
     if (size_ < capacity_) { \
         traits::construct(alloc_, arr_ + size_, method_argument_transmission); \
-    } else if (capacity_ == 0) { \
-        ++capacity_; \
-        arr_ = traits::allocate(alloc_, capacity_); \
-        traits::construct(alloc_, arr_, method_argument_transmission); \
     } else { \
-        assert(size_ == capacity_); \
-        capacity_ *= 2; \
-        T* new_arr = traits::allocate(alloc_, capacity_); \
-        traits::construct(alloc_, new_arr + size_, method_argument_transmission); \
-        for (size_t i = 0; i < size_; ++i) { \
-            traits::construct(alloc_, new_arr + i, std::move_if_noexcept(arr_[i])); \
-            traits::destroy(alloc_, arr_ + i); \
-        } \
-        traits::deallocate(alloc_, arr_, size_); \
-        arr_ = new_arr; \
+        grow_and_emplace_back(method_argument_transmission); \
     } \
     ++size_; \
 }
@@ -469,17 +686,23 @@ void Vector<T, Alloc>::emplace_back(Args &&... args) {
 
 #define ReallockIf(condition, new_capacity) { \
     if (condition) { \
-        T* new_arr = traits::allocate(alloc_, new_capacity); \
-        for (size_t i = 0; i < size_; ++i) { \
-            traits::construct(alloc_, new_arr + i, std::move_if_noexcept(arr_[i])); \
-            traits::destroy(alloc_, arr_ + i); \
-        } \
-        traits::deallocate(alloc_, arr_, capacity_); \
-        arr_ = new_arr; \
-        capacity_ = new_capacity; \
+        size_t realloc_capacity = new_capacity; \
+        T* new_arr = allocate_at_least(realloc_capacity); \
+        StorageGuard guard(alloc_, new_arr, realloc_capacity); \
+        guard.relocate(arr_, size_); \
+        replace_storage(guard); \
     } \
 }
 
+// Shrinking after an erase only saves memory, so when relocation throws
+// the larger buffer is kept and the erase still succeeds.
+template<class T, class Alloc>
+void Vector<T, Alloc>::try_shrink(size_t new_capacity) noexcept {
+    try {
+        ReallockIf(true, new_capacity)
+    } catch (...) {}
+}
+
 template<class T, class Alloc>
 void Vector<T, Alloc>::pop_back() {
     if (this->empty()) {
@@ -489,8 +712,8 @@ void Vector<T, Alloc>::pop_back() {
     traits::destroy(alloc_, arr_ + size_);
     if (this->empty()) {
         this->clear();
-    } else {
-        ReallockIf(size_ <= capacity_ / 4, capacity_ / 2)
+    } else if (size_ <= capacity_ / 4) {
+        try_shrink(capacity_ / 2);
     }
 }
 
@@ -517,13 +740,28 @@ void Vector<T, Alloc>::resize(size_t new_size, const T& value) {
         }
         size_ = new_size;
         if (size_ <= capacity_ / 4) {
-            this->shrink_to_fit();
+            try_shrink(size_);
         }
     }
 }
 
+template<class T, class Alloc>
+T* Vector<T, Alloc>::reserve_back(size_t count) {
+    const size_t required = size_ + count;
+    ReallockIf(required > capacity_, required > 2 * capacity_ ? required : 2 * capacity_)
+    return arr_ + size_;
+}
+
 #undef ReallockIf
 
+template<class T, class Alloc>
+void Vector<T, Alloc>::commit(size_t count) {
+    if (count > capacity_ - size_) {
+        throw std::logic_error("committing more elements than were reserved");
+    }
+    size_ += count;
+}
+
 
 template<class T, class Alloc>
 T& Vector<T, Alloc>::operator[](size_t ind) {
@@ -610,6 +848,10 @@ template<class T, class Alloc>
 size_t Vector<T, Alloc>::size() const noexcept {
     return size_;
 }
+template<class T, class Alloc>
+Alloc Vector<T, Alloc>::get_allocator() const noexcept {
+    return alloc_;
+}
 
 template<class T, class Alloc>
 int Vector<T, Alloc>::compare(const Vector& rhs) const {
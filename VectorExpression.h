@@ -0,0 +1,339 @@
+#ifndef VECTOR_EXPRESSION_H
+#define VECTOR_EXPRESSION_H
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "Vector.h"
+
+// Lazy element-wise arithmetic over numeric Vectors.
+// Operators build an expression tree that is evaluated by assign() or
+// evaluate() in a single fused loop, without intermediate Vectors:
+//
+//     assign(y, a * x + y);
+//     Vector<float> r = evaluate(elementwise::clamp(x * 2.0f, 0.0f, 1.0f));
+//
+// Operands must have equal sizes; scalars are broadcast.
+
+template <class T>
+class VectorOperand;
+
+template <class T>
+class ScalarOperand;
+
+template <class Operation, class Arg>
+class UnaryExpression;
+
+template <class Operation, class Lhs, class Rhs>
+class BinaryExpression;
+
+
+template <class E>
+struct IsVectorExpression : std::false_type {};
+
+template <class T, class Alloc>
+struct IsVectorExpression<Vector<T, Alloc>> : std::is_arithmetic<T> {};
+
+template <class Operation, class Arg>
+struct IsVectorExpression<UnaryExpression<Operation, Arg>> : std::true_type {};
+
+template <class Operation, class Lhs, class Rhs>
+struct IsVectorExpression<BinaryExpression<Operation, Lhs, Rhs>> : std::true_type {};
+
+template <class E>
+struct IsExpressionArgument : std::integral_constant<bool,
+        IsVectorExpression<E>::value || std::is_arithmetic<E>::value> {};
+
+
+// Maps an argument to the node stored in the tree: Vectors are captured
+// by their storage, scalars by value and subexpressions by copy.
+template <class E, class = void>
+struct ExpressionOperand {
+    using type = E;
+};
+
+template <class T, class Alloc>
+struct ExpressionOperand<Vector<T, Alloc>> {
+    using type = VectorOperand<T>;
+};
+
+template <class E>
+struct ExpressionOperand<E, typename std::enable_if<std::is_arithmetic<E>::value>::type> {
+    using type = ScalarOperand<E>;
+};
+
+template <class E>
+using ExpressionOperandType = typename ExpressionOperand<E>::type;
+
+template <class E>
+using ExpressionValueType = typename std::decay<decltype(std::declval<const ExpressionOperandType<E>&>()[0])>::type;
+
+
+template <class T>
+class VectorOperand {
+public:
+    template <class Alloc>
+    VectorOperand(const Vector<T, Alloc>& vector) : data_(vector.data()), size_(vector.size()) {}
+
+    T operator[](size_t ind) const {
+        return data_[ind];
+    }
+    size_t size() const noexcept {
+        return size_;
+    }
+    bool broadcast() const noexcept {
+        return false;
+    }
+
+private:
+    const T* data_;
+    size_t size_;
+};
+
+template <class T>
+class ScalarOperand {
+public:
+    ScalarOperand(T value) : value_(value) {}
+
+    T operator[](size_t ) const {
+        return value_;
+    }
+    size_t size() const noexcept {
+        return 0;
+    }
+    bool broadcast() const noexcept {
+        return true;
+    }
+
+private:
+    T value_;
+};
+
+
+template <class Operation, class Arg>
+class UnaryExpression {
+public:
+    explicit UnaryExpression(const Arg& arg) : arg_(arg) {}
+
+    auto operator[](size_t ind) const {
+        return Operation()(arg_[ind]);
+    }
+    size_t size() const noexcept {
+        return arg_.size();
+    }
+    bool broadcast() const noexcept {
+        return false;
+    }
+
+private:
+    Arg arg_;
+};
+
+template <class Operation, class Lhs, class Rhs>
+class BinaryExpression {
+public:
+    BinaryExpression(const Lhs& lhs, const Rhs& rhs) : lhs_(lhs), rhs_(rhs) {
+        if (!lhs_.broadcast() && !rhs_.broadcast() && lhs_.size() != rhs_.size()) {
+            throw std::invalid_argument("Element-wise operation on Vectors of different sizes");
+        }
+        size_ = lhs_.broadcast() ? rhs_.size() : lhs_.size();
+    }
+
+    auto operator[](size_t ind) const {
+        return Operation()(lhs_[ind], rhs_[ind]);
+    }
+    size_t size() const noexcept {
+        return size_;
+    }
+    bool broadcast() const noexcept {
+        return false;
+    }
+
+private:
+    Lhs lhs_;
+    Rhs rhs_;
+    size_t size_;
+};
+
+template <class Operation, class Lhs, class Rhs>
+using EnableIfBinaryExpression = typename std::enable_if<
+        (IsVectorExpression<Lhs>::value || IsVectorExpression<Rhs>::value) &&
+        IsExpressionArgument<Lhs>::value && IsExpressionArgument<Rhs>::value,
+        BinaryExpression<Operation, ExpressionOperandType<Lhs>, ExpressionOperandType<Rhs>>>::type;
+
+template <class Operation, class Lhs, class Rhs>
+EnableIfBinaryExpression<Operation, Lhs, Rhs> make_binary_expression(const Lhs& lhs, const Rhs& rhs) {
+    return EnableIfBinaryExpression<Operation, Lhs, Rhs>(lhs, rhs);
+}
+
+
+struct ExpressionPlus {
+    template <class A, class B>
+    auto operator()(A a, B b) const { return a + b; }
+};
+struct ExpressionMinus {
+    template <class A, class B>
+    auto operator()(A a, B b) const { return a - b; }
+};
+struct ExpressionMultiplies {
+    template <class A, class B>
+    auto operator()(A a, B b) const { return a * b; }
+};
+struct ExpressionDivides {
+    template <class A, class B>
+    auto operator()(A a, B b) const { return a / b; }
+};
+struct ExpressionNegate {
+    template <class A>
+    auto operator()(A a) const { return -a; }
+};
+struct ExpressionMin {
+    template <class A, class B>
+    auto operator()(A a, B b) const -> typename std::common_type<A, B>::type {
+        return b < a ? b : a;
+    }
+};
+struct ExpressionMax {
+    template <class A, class B>
+    auto operator()(A a, B b) const -> typename std::common_type<A, B>::type {
+        return a < b ? b : a;
+    }
+};
+struct ExpressionLess {
+    template <class A, class B>
+    bool operator()(A a, B b) const { return a < b; }
+};
+struct ExpressionLessEqual {
+    template <class A, class B>
+    bool operator()(A a, B b) const { return a <= b; }
+};
+struct ExpressionGreater {
+    template <class A, class B>
+    bool operator()(A a, B b) const { return a > b; }
+};
+struct ExpressionGreaterEqual {
+    template <class A, class B>
+    bool operator()(A a, B b) const { return a >= b; }
+};
+struct ExpressionEqual {
+    template <class A, class B>
+    bool operator()(A a, B b) const { return a == b; }
+};
+struct ExpressionNotEqual {
+    template <class A, class B>
+    bool operator()(A a, B b) const { return a != b; }
+};
+
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionPlus, Lhs, Rhs> operator+(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionPlus>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionMinus, Lhs, Rhs> operator-(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionMinus>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionMultiplies, Lhs, Rhs> operator*(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionMultiplies>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionDivides, Lhs, Rhs> operator/(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionDivides>(lhs, rhs);
+}
+
+template <class Arg>
+typename std::enable_if<IsVectorExpression<Arg>::value,
+                        UnaryExpression<ExpressionNegate, ExpressionOperandType<Arg>>>::type
+        operator-(const Arg& arg) {
+    return UnaryExpression<ExpressionNegate, ExpressionOperandType<Arg>>(arg);
+}
+
+
+// min/max/clamp and comparison masks live in a namespace: unqualified
+// min(a, b) on two Vectors would find std::min through ADL, and the
+// relational operators on Vector already mean lexicographic comparison.
+namespace elementwise {
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionMin, Lhs, Rhs> min(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionMin>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionMax, Lhs, Rhs> max(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionMax>(lhs, rhs);
+}
+
+template <class Arg, class Low, class High>
+auto clamp(const Arg& arg, const Low& low, const High& high) -> decltype(elementwise::min(elementwise::max(arg, low), high)) {
+    return elementwise::min(elementwise::max(arg, low), high);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionLess, Lhs, Rhs> less(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionLess>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionLessEqual, Lhs, Rhs> less_equal(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionLessEqual>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionGreater, Lhs, Rhs> greater(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionGreater>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionGreaterEqual, Lhs, Rhs> greater_equal(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionGreaterEqual>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionEqual, Lhs, Rhs> equal(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionEqual>(lhs, rhs);
+}
+
+template <class Lhs, class Rhs>
+EnableIfBinaryExpression<ExpressionNotEqual, Lhs, Rhs> not_equal(const Lhs& lhs, const Rhs& rhs) {
+    return make_binary_expression<ExpressionNotEqual>(lhs, rhs);
+}
+
+} // namespace elementwise
+
+
+// Evaluates the expression into destination, reusing its storage when the sizes match.
+// destination may appear among the operands: element i is read before it is written.
+template <class T, class Alloc, class E>
+typename std::enable_if<IsVectorExpression<E>::value>::type
+        assign(Vector<T, Alloc>& destination, const E& expression) {
+    const ExpressionOperandType<E> tree(expression);
+    const size_t size = tree.size();
+    if (destination.size() != size) {
+        destination.resize(size);
+    }
+
+    // Distinct Vectors never overlap, so out can only alias an operand at the same index.
+    T* out = destination.data();
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC ivdep
+#endif
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<T>(tree[i]);
+    }
+}
+
+template <class E>
+typename std::enable_if<IsVectorExpression<E>::value, Vector<ExpressionValueType<E>>>::type
+        evaluate(const E& expression) {
+    Vector<ExpressionValueType<E>> result;
+    assign(result, expression);
+    return result;
+}
+
+
+#endif //VECTOR_EXPRESSION_H
@@ -0,0 +1,112 @@
+#ifndef VECTOR_IO_H
+#define VECTOR_IO_H
+
+#include <algorithm>
+#include <cerrno>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Vector.h"
+
+// Appending raw elements from files, sockets and streams.
+// Bytes are read straight into the spare capacity of the Vector (see
+// Vector::reserve_back) and committed as whole elements, so there is no
+// intermediate buffer. The elements must be trivially copyable and are taken
+// in the byte order of the machine.
+//
+// Reading stops at the end of input or after max_bytes bytes, which should
+// therefore be a multiple of sizeof(T). When the input ends inside an
+// element, the complete elements stay appended and std::runtime_error is
+// thrown. Read errors throw std::system_error (std::ios_base::failure for
+// streams) after appending what was read before them.
+
+// Reads through read_bytes(buffer, size), which returns the number of bytes
+// read and 0 at the end of input. size_hint is the expected input size.
+template <class T, class Alloc, class ReadBytes>
+size_t append_bytes(Vector<T, Alloc>& values, size_t max_bytes, size_t size_hint, ReadBytes read_bytes) {
+    static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable elements can be read as bytes");
+
+    const size_t old_size = values.size();
+    const size_t min_chunk = (64 << 10) / sizeof(T) + 1;
+    // One element more than the hint, so that the end of input is seen without growing.
+    size_t next_chunk = std::min(size_hint, max_bytes) / sizeof(T) + 1;
+
+    // Bytes of an incomplete element, kept right after the last committed one.
+    // Spare capacity is whole elements, so it never runs out while pending != 0.
+    size_t pending = 0;
+
+    size_t total = 0;
+    while (total < max_bytes) {
+        size_t spare_bytes = (values.capacity() - values.size()) * sizeof(T);
+        if (spare_bytes == 0) {
+            values.reserve_back(std::max(next_chunk, min_chunk));
+            spare_bytes = (values.capacity() - values.size()) * sizeof(T);
+            next_chunk = 0;
+        }
+
+        char* buffer = reinterpret_cast<char*>(values.data() + values.size()) + pending;
+        const size_t count = read_bytes(buffer, std::min(spare_bytes - pending, max_bytes - total));
+        if (count == 0) {
+            break;
+        }
+        total += count;
+        pending += count;
+        values.commit(pending / sizeof(T));
+        pending %= sizeof(T);
+    }
+
+    if (pending != 0) {
+        throw std::runtime_error("input ends inside an element");
+    }
+    return values.size() - old_size;
+}
+
+// Appends the contents of fd from its current offset, retrying reads interrupted by signals.
+// Regular files are read into a single allocation sized from fstat().
+template <class T, class Alloc>
+size_t append_from_fd(Vector<T, Alloc>& values, int fd,
+                      size_t max_bytes = std::numeric_limits<size_t>::max()) {
+    size_t size_hint = 0;
+    struct stat status;
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode)) {
+        const off_t offset = lseek(fd, 0, SEEK_CUR);
+        if (offset >= 0 && offset < status.st_size) {
+            size_hint = static_cast<size_t>(status.st_size - offset);
+        }
+    }
+
+    return append_bytes(values, max_bytes, size_hint, [fd](char* buffer, size_t size) -> size_t {
+        const size_t max_read = static_cast<size_t>(std::numeric_limits<ssize_t>::max());
+        while (true) {
+            const ssize_t count = read(fd, buffer, std::min(size, max_read));
+            if (count >= 0) {
+                return static_cast<size_t>(count);
+            }
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "read");
+            }
+        }
+    });
+}
+
+template <class T, class Alloc>
+size_t append_from_istream(Vector<T, Alloc>& values, std::istream& in,
+                           size_t max_bytes = std::numeric_limits<size_t>::max()) {
+    return append_bytes(values, max_bytes, 0, [&in](char* buffer, size_t size) -> size_t {
+        const size_t max_read = static_cast<size_t>(std::numeric_limits<std::streamsize>::max());
+        in.read(buffer, static_cast<std::streamsize>(std::min(size, max_read)));
+        if (in.bad()) {
+            throw std::ios_base::failure("stream read failed");
+        }
+        return static_cast<size_t>(in.gcount());
+    });
+}
+
+
+#endif //VECTOR_IO_H
@@ -0,0 +1,571 @@
+#ifndef VECTOR_SIMD_H
+#define VECTOR_SIMD_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <utility>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#include "Vector.h"
+
+// Vectorized search and reduction kernels over Vector storage.
+// Elements of 32- and 64-bit integral and floating types go through kernels
+// written with GCC vector extensions. Each kernel is instantiated for SSE2,
+// AVX2 and AVX-512 and picked at runtime; any other element type uses the
+// matching std algorithm. Call the functions qualified (simd::find(v, x)),
+// so that ADL does not mix them up with the std algorithms.
+//
+// sum() and dot() of floating-point elements add in a different order than
+// std::accumulate, so their results may differ in the last bits.
+
+enum class SimdLevel {
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+};
+
+template <class E>
+struct IsSimdElement : std::integral_constant<bool,
+        ((std::is_integral<E>::value && !std::is_same<E, bool>::value) || std::is_floating_point<E>::value) &&
+        (sizeof(E) == 4 || sizeof(E) == 8)> {};
+
+
+// Vector types wider than the baseline ISA only cross function boundaries
+// inside the target-specific instances below.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// Whether any lane of a comparison mask is set. Generic vector code folds
+// lanes one by one, so x86 registers get a single test instruction.
+template <size_t Bytes>
+struct SimdAny {
+    template <class Mask>
+    static bool test(const Mask& mask) {
+        bool result = false;
+        for (size_t lane = 0; lane < sizeof(Mask) / sizeof(mask[0]); ++lane) {
+            result |= (mask[lane] != 0);
+        }
+        return result;
+    }
+};
+
+#if defined(VECTOR_SIMD_X86)
+template <>
+struct SimdAny<16> {
+    template <class Mask>
+    __attribute__((target("sse2"))) static bool test(const Mask& mask) {
+        __m128i bits;
+        std::memcpy(&bits, &mask, sizeof(bits));
+        return _mm_movemask_epi8(bits) != 0;
+    }
+};
+
+template <>
+struct SimdAny<32> {
+    template <class Mask>
+    __attribute__((target("avx"))) static bool test(const Mask& mask) {
+        __m256i bits;
+        std::memcpy(&bits, &mask, sizeof(bits));
+        return !_mm256_testz_si256(bits, bits);
+    }
+};
+
+template <>
+struct SimdAny<64> {
+    template <class Mask>
+    __attribute__((target("avx512f"))) static bool test(const Mask& mask) {
+        __m512i bits;
+        std::memcpy(&bits, &mask, sizeof(bits));
+        return _mm512_test_epi64_mask(bits, bits) != 0;
+    }
+};
+#endif
+
+// Kernels over Bytes-wide registers. Heads and tails that do not fill a
+// register are handled by scalar loops; loads are unaligned. The kernels are
+// flattened into the target-specific instances below, so they compile to
+// the instruction set of the instance.
+template <class E, size_t Bytes>
+struct SimdKernels {
+    typedef E Lanes __attribute__((vector_size(Bytes)));
+    // Integers are summed in unsigned lanes, where wrap-around is defined.
+    using SumElement = typename std::conditional<std::is_integral<E>::value,
+                                                 std::make_unsigned<E>, std::common_type<E>>::type::type;
+    typedef SumElement SumLanes __attribute__((vector_size(Bytes)));
+    using Mask = decltype(Lanes() == Lanes());
+    typedef unsigned char Bits __attribute__((vector_size(Bytes)));
+
+    static const size_t width = Bytes / sizeof(E);
+    static const size_t unroll = 4;
+
+    __attribute__((always_inline)) static Lanes load(const E* data) {
+        Lanes result;
+        std::memcpy(&result, data, sizeof(result));
+        return result;
+    }
+
+    // Matches in unroll consecutive registers. The masks are combined as raw
+    // bits: GCC cannot lower an OR of AVX-512 comparison masks as a vector.
+    static bool any_match(const E* block, E value) {
+        Bits hit = (Bits)(load(block) == value) | (Bits)(load(block + width) == value) |
+                   (Bits)(load(block + 2 * width) == value) | (Bits)(load(block + 3 * width) == value);
+        return SimdAny<Bytes>::test(hit);
+    }
+
+    static size_t find(const E* data, size_t size, E value) {
+        size_t i = 0;
+        for (; i + unroll * width <= size; i += unroll * width) {
+            if (any_match(data + i, value)) {
+                break;
+            }
+        }
+        for (; i < size; ++i) {
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    static size_t find_last(const E* data, size_t size, E value) {
+        size_t i = size;
+        for (; i >= unroll * width; i -= unroll * width) {
+            if (any_match(data + i - unroll * width, value)) {
+                break;
+            }
+        }
+        while (i > 0) {
+            --i;
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    static size_t count(const E* data, size_t size, E value) {
+        // Lanes count matches as -1 each; flush before they can overflow.
+        const size_t flush_period = size_t(1) << (sizeof(E) * 8 - 2);
+        size_t result = 0, i = 0;
+        while (i + width <= size) {
+            Mask matches = Mask();
+            for (size_t block = 0; block < flush_period && i + width <= size; ++block, i += width) {
+                matches += (load(data + i) == value);
+            }
+            for (size_t lane = 0; lane < width; ++lane) {
+                result -= matches[lane];
+            }
+        }
+        for (; i < size; ++i) {
+            result += (data[i] == value);
+        }
+        return result;
+    }
+
+    // Reports through unordered whether the range contains NaN, in which case
+    // the returned bounds are meaningless.
+    static void minmax(const E* data, size_t size,
+                                                      E& min_value, E& max_value, bool& unordered) {
+        size_t i = 0;
+        min_value = max_value = data[0];
+        unordered = (data[0] != data[0]);
+        if (size >= width) {
+            Lanes low = load(data), high = low;
+            Mask nan = (low != low);
+            for (i = width; i + width <= size; i += width) {
+                Lanes next = load(data + i);
+                low = next < low ? next : low;
+                high = high < next ? next : high;
+                nan |= (next != next);
+            }
+            unordered = SimdAny<Bytes>::test(nan);
+            for (size_t lane = 0; lane < width; ++lane) {
+                min_value = low[lane] < min_value ? low[lane] : min_value;
+                max_value = max_value < high[lane] ? high[lane] : max_value;
+            }
+        }
+        for (; i < size; ++i) {
+            min_value = data[i] < min_value ? data[i] : min_value;
+            max_value = max_value < data[i] ? data[i] : max_value;
+            unordered |= (data[i] != data[i]);
+        }
+    }
+
+    static E sum(const E* data, size_t size) {
+        SumLanes partial[unroll] = {};
+        size_t i = 0;
+        for (; i + unroll * width <= size; i += unroll * width) {
+            for (size_t k = 0; k < unroll; ++k) {
+                partial[k] += (SumLanes)load(data + i + k * width);
+            }
+        }
+        return reduce(partial, data + i, data + i, size - i);
+    }
+
+    static E dot(const E* lhs, const E* rhs, size_t size) {
+        SumLanes partial[unroll] = {};
+        size_t i = 0;
+        for (; i + unroll * width <= size; i += unroll * width) {
+            for (size_t k = 0; k < unroll; ++k) {
+                partial[k] += (SumLanes)load(lhs + i + k * width) * (SumLanes)load(rhs + i + k * width);
+            }
+        }
+        return reduce(partial, lhs + i, rhs + i, size - i, true);
+    }
+
+    static E reduce(const SumLanes* partial, const E* lhs, const E* rhs,
+                                                   size_t tail, bool product = false) {
+        SumLanes total = partial[0];
+        for (size_t k = 1; k < unroll; ++k) {
+            total += partial[k];
+        }
+        SumElement result = SumElement();
+        for (size_t lane = 0; lane < width; ++lane) {
+            result += total[lane];
+        }
+        for (size_t i = 0; i < tail; ++i) {
+            result += product ? static_cast<SumElement>(lhs[i]) * static_cast<SumElement>(rhs[i])
+                              : static_cast<SumElement>(lhs[i]);
+        }
+        return static_cast<E>(result);
+    }
+};
+
+
+template <class E>
+struct SimdTable {
+    size_t (*find)(const E* , size_t , E );
+    size_t (*find_last)(const E* , size_t , E );
+    size_t (*count)(const E* , size_t , E );
+    void (*minmax)(const E* , size_t , E& , E& , bool& );
+    E (*sum)(const E* , size_t );
+    E (*dot)(const E* , const E* , size_t );
+
+    static const SimdTable& active();
+};
+
+
+#define VectorSimdInstance(isa, isa_attributes, bytes) \
+    template <class E> __attribute__((flatten)) isa_attributes \
+    size_t simd_find_##isa(const E* data, size_t size, E value) { \
+        return SimdKernels<E, bytes>::find(data, size, value); \
+    } \
+    template <class E> __attribute__((flatten)) isa_attributes \
+    size_t simd_find_last_##isa(const E* data, size_t size, E value) { \
+        return SimdKernels<E, bytes>::find_last(data, size, value); \
+    } \
+    template <class E> __attribute__((flatten)) isa_attributes \
+    size_t simd_count_##isa(const E* data, size_t size, E value) { \
+        return SimdKernels<E, bytes>::count(data, size, value); \
+    } \
+    template <class E> __attribute__((flatten)) isa_attributes \
+    void simd_minmax_##isa(const E* data, size_t size, E& min_value, E& max_value, bool& unordered) { \
+        SimdKernels<E, bytes>::minmax(data, size, min_value, max_value, unordered); \
+    } \
+    template <class E> __attribute__((flatten)) isa_attributes \
+    E simd_sum_##isa(const E* data, size_t size) { \
+        return SimdKernels<E, bytes>::sum(data, size); \
+    } \
+    template <class E> __attribute__((flatten)) isa_attributes \
+    E simd_dot_##isa(const E* lhs, const E* rhs, size_t size) { \
+        return SimdKernels<E, bytes>::dot(lhs, rhs, size); \
+    } \
+    template <class E> \
+    SimdTable<E> simd_table_##isa() { \
+        return {simd_find_##isa<E>, simd_find_last_##isa<E>, simd_count_##isa<E>, \
+                simd_minmax_##isa<E>, simd_sum_##isa<E>, simd_dot_##isa<E>}; \
+    }
+
+#if defined(VECTOR_SIMD_X86)
+VectorSimdInstance(scalar, , sizeof(E))
+VectorSimdInstance(sse2, __attribute__((target("sse2"))), 16)
+VectorSimdInstance(avx2, __attribute__((target("avx2"))), 32)
+VectorSimdInstance(avx512, __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl"))), 64)
+#else
+VectorSimdInstance(scalar, , sizeof(E))
+#endif
+
+#undef VectorSimdInstance
+#pragma GCC diagnostic pop
+
+
+namespace simd {
+
+inline SimdLevel supported_level() {
+#if defined(VECTOR_SIMD_X86)
+    __builtin_cpu_init();
+    // The AVX-512 kernels are compiled for all four subsets; AVX-512F alone (Xeon Phi) is not enough.
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+inline std::atomic<int>& selected_level() {
+    static std::atomic<int> level(static_cast<int>(supported_level()));
+    return level;
+}
+
+// Restricts the kernels to the given instruction set (clamped to what the CPU supports).
+inline void set_level(SimdLevel level) {
+    selected_level() = std::min(static_cast<int>(level), static_cast<int>(supported_level()));
+}
+
+inline SimdLevel level() {
+    return static_cast<SimdLevel>(selected_level().load(std::memory_order_relaxed));
+}
+
+} // namespace simd
+
+
+template <class E>
+const SimdTable<E>& SimdTable<E>::active() {
+#if defined(VECTOR_SIMD_X86)
+    static const SimdTable tables[] = {simd_table_scalar<E>(), simd_table_sse2<E>(),
+                                       simd_table_avx2<E>(), simd_table_avx512<E>()};
+#else
+    static const SimdTable tables[] = {simd_table_scalar<E>()};
+#endif
+    return tables[static_cast<int>(simd::level())];
+}
+
+
+template <class Iterator>
+struct IsVectorIterator : std::integral_constant<bool,
+        std::is_same<Iterator, typename Iterator::container_type::Iterator>::value ||
+        std::is_same<Iterator, typename Iterator::container_type::ConstIterator>::value> {};
+
+template <class Iterator, class Result>
+using EnableIfVectorIterator = typename std::enable_if<IsVectorIterator<Iterator>::value, Result>::type;
+
+template <class Iterator>
+using IteratorElement = typename std::remove_const<typename Iterator::value_type>::type;
+
+
+namespace simd {
+
+// Index-level implementations: SIMD kernels for supported elements, std algorithms otherwise.
+
+template <class T>
+size_t find(const T* data, size_t size, const T& value, std::false_type) {
+    return std::find(data, data + size, value) - data;
+}
+
+template <class T>
+size_t find(const T* data, size_t size, const T& value, std::true_type) {
+    return SimdTable<T>::active().find(data, size, value);
+}
+
+template <class T>
+size_t count(const T* data, size_t size, const T& value, std::false_type) {
+    return std::count(data, data + size, value);
+}
+
+template <class T>
+size_t count(const T* data, size_t size, const T& value, std::true_type) {
+    return SimdTable<T>::active().count(data, size, value);
+}
+
+// First minimum and last maximum, as std::minmax_element.
+template <class T>
+std::pair<size_t, size_t> minmax(const T* data, size_t size, std::false_type) {
+    auto bounds = std::minmax_element(data, data + size);
+    return std::make_pair(bounds.first - data, bounds.second - data);
+}
+
+template <class T>
+std::pair<size_t, size_t> minmax(const T* data, size_t size, std::true_type) {
+    if (size == 0) {
+        return std::make_pair(size, size);
+    }
+    const SimdTable<T>& table = SimdTable<T>::active();
+    T min_value, max_value;
+    bool unordered;
+    table.minmax(data, size, min_value, max_value, unordered);
+    if (unordered) {
+        return simd::minmax(data, size, std::false_type());
+    }
+    return std::make_pair(table.find(data, size, min_value), table.find_last(data, size, max_value));
+}
+
+template <class T>
+size_t min_element(const T* data, size_t size, std::false_type) {
+    return std::min_element(data, data + size) - data;
+}
+
+template <class T>
+size_t min_element(const T* data, size_t size, std::true_type) {
+    if (size == 0) {
+        return size;
+    }
+    const SimdTable<T>& table = SimdTable<T>::active();
+    T min_value, max_value;
+    bool unordered;
+    table.minmax(data, size, min_value, max_value, unordered);
+    if (unordered) {
+        return simd::min_element(data, size, std::false_type());
+    }
+    return table.find(data, size, min_value);
+}
+
+template <class T>
+size_t max_element(const T* data, size_t size, std::false_type) {
+    return std::max_element(data, data + size) - data;
+}
+
+template <class T>
+size_t max_element(const T* data, size_t size, std::true_type) {
+    if (size == 0) {
+        return size;
+    }
+    const SimdTable<T>& table = SimdTable<T>::active();
+    T min_value, max_value;
+    bool unordered;
+    table.minmax(data, size, min_value, max_value, unordered);
+    if (unordered) {
+        return simd::max_element(data, size, std::false_type());
+    }
+    return table.find(data, size, max_value);
+}
+
+template <class T>
+T sum(const T* data, size_t size, std::false_type) {
+    return std::accumulate(data, data + size, T());
+}
+
+template <class T>
+T sum(const T* data, size_t size, std::true_type) {
+    return SimdTable<T>::active().sum(data, size);
+}
+
+template <class T>
+T dot(const T* lhs, const T* rhs, size_t size, std::false_type) {
+    return std::inner_product(lhs, lhs + size, rhs, T());
+}
+
+template <class T>
+T dot(const T* lhs, const T* rhs, size_t size, std::true_type) {
+    return SimdTable<T>::active().dot(lhs, rhs, size);
+}
+
+template <class Iterator>
+EnableIfVectorIterator<Iterator, Iterator> find(Iterator first, Iterator last, const IteratorElement<Iterator>& value) {
+    auto data = first.operator->();
+    size_t size = last.operator->() - data;
+    return Iterator(data + simd::find(data, size, value, IsSimdElement<IteratorElement<Iterator>>()));
+}
+
+template <class Iterator>
+EnableIfVectorIterator<Iterator, size_t> count(Iterator first, Iterator last, const IteratorElement<Iterator>& value) {
+    auto data = first.operator->();
+    size_t size = last.operator->() - data;
+    return simd::count(data, size, value, IsSimdElement<IteratorElement<Iterator>>());
+}
+
+template <class Iterator>
+EnableIfVectorIterator<Iterator, bool> contains(Iterator first, Iterator last, const IteratorElement<Iterator>& value) {
+    return simd::find(first, last, value) != last;
+}
+
+template <class Iterator>
+EnableIfVectorIterator<Iterator, std::pair<Iterator, Iterator>> minmax(Iterator first, Iterator last) {
+    auto data = first.operator->();
+    size_t size = last.operator->() - data;
+    auto bounds = simd::minmax(data, size, IsSimdElement<IteratorElement<Iterator>>());
+    return std::make_pair(Iterator(data + bounds.first), Iterator(data + bounds.second));
+}
+
+template <class Iterator>
+EnableIfVectorIterator<Iterator, Iterator> min_element(Iterator first, Iterator last) {
+    auto data = first.operator->();
+    size_t size = last.operator->() - data;
+    return Iterator(data + simd::min_element(data, size, IsSimdElement<IteratorElement<Iterator>>()));
+}
+
+template <class Iterator>
+EnableIfVectorIterator<Iterator, Iterator> max_element(Iterator first, Iterator last) {
+    auto data = first.operator->();
+    size_t size = last.operator->() - data;
+    return Iterator(data + simd::max_element(data, size, IsSimdElement<IteratorElement<Iterator>>()));
+}
+
+template <class Iterator>
+EnableIfVectorIterator<Iterator, IteratorElement<Iterator>> sum(Iterator first, Iterator last) {
+    auto data = first.operator->();
+    size_t size = last.operator->() - data;
+    return simd::sum(data, size, IsSimdElement<IteratorElement<Iterator>>());
+}
+
+template <class Iterator>
+EnableIfVectorIterator<Iterator, IteratorElement<Iterator>> dot(Iterator first, Iterator last, Iterator other_first) {
+    auto data = first.operator->();
+    size_t size = last.operator->() - data;
+    return simd::dot(data, other_first.operator->(), size, IsSimdElement<IteratorElement<Iterator>>());
+}
+
+
+template <class T, class Alloc>
+typename Vector<T, Alloc>::ConstIterator find(const Vector<T, Alloc>& vector, const T& value) {
+    return simd::find(vector.cbegin(), vector.cend(), value);
+}
+
+template <class T, class Alloc>
+size_t count(const Vector<T, Alloc>& vector, const T& value) {
+    return simd::count(vector.cbegin(), vector.cend(), value);
+}
+
+template <class T, class Alloc>
+bool contains(const Vector<T, Alloc>& vector, const T& value) {
+    return simd::contains(vector.cbegin(), vector.cend(), value);
+}
+
+template <class T, class Alloc>
+std::pair<typename Vector<T, Alloc>::ConstIterator, typename Vector<T, Alloc>::ConstIterator>
+        minmax(const Vector<T, Alloc>& vector) {
+    return simd::minmax(vector.cbegin(), vector.cend());
+}
+
+template <class T, class Alloc>
+typename Vector<T, Alloc>::ConstIterator min_element(const Vector<T, Alloc>& vector) {
+    return simd::min_element(vector.cbegin(), vector.cend());
+}
+
+template <class T, class Alloc>
+typename Vector<T, Alloc>::ConstIterator max_element(const Vector<T, Alloc>& vector) {
+    return simd::max_element(vector.cbegin(), vector.cend());
+}
+
+template <class T, class Alloc>
+T sum(const Vector<T, Alloc>& vector) {
+    return simd::sum(vector.cbegin(), vector.cend());
+}
+
+// The Vectors must have equal sizes.
+template <class T, class Alloc>
+T dot(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs) {
+    if (lhs.size() != rhs.size()) {
+        throw std::invalid_argument("dot product of Vectors of different sizes");
+    }
+    return simd::dot(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+}
+
+
+} // namespace simd
+
+
+#endif //VECTOR_SIMD_H
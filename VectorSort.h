@@ -0,0 +1,361 @@
+#ifndef VECTOR_SORT_H
+#define VECTOR_SORT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "Vector.h"
+
+// Sorting of Vector contents.
+//
+//     sorting::sort(v);                  // radix sort for integral and floating elements
+//     sorting::sort(v, comp);            // parallel merge sort
+//     sorting::stable_sort(v, comp);
+//     sorting::radix_sort(v, key);       // stable LSD radix sort of structs by key(element)
+//
+// Call the functions qualified, so that ADL does not mix them up with std::sort.
+//
+// Radix sort orders floating keys by their bit patterns: -0.0 precedes 0.0,
+// and NaNs go to the ends according to their sign bit.
+// Parallel sorts split the Vector into one chunk per thread, sort the chunks
+// with std::sort (std::stable_sort) and merge them pairwise, each merge split
+// between the threads along the merge path. Elements whose moves may throw
+// are sorted on the calling thread. If the comparator throws, the Vector keeps
+// valid but unspecified elements.
+// Radix sort calls a key function that is not noexcept once per element,
+// before any element is moved, and keeps the keys next to the elements; if it
+// throws, the Vector is unchanged. A noexcept key is recomputed on every pass
+// instead, which saves the memory for the keys.
+
+namespace sorting {
+
+// Maps keys to unsigned integers with the same order.
+template <class Key, class = void>
+struct RadixKey;
+
+template <class Key>
+struct RadixKey<Key, typename std::enable_if<std::is_integral<Key>::value && !std::is_same<Key, bool>::value>::type> {
+    using Bits = typename std::make_unsigned<Key>::type;
+
+    static Bits map(Key key) noexcept {
+        Bits bits = static_cast<Bits>(key);
+        if (std::is_signed<Key>::value) {
+            bits ^= Bits(1) << (8 * sizeof(Bits) - 1);
+        }
+        return bits;
+    }
+};
+
+template <class Key>
+struct RadixKey<Key, typename std::enable_if<std::is_floating_point<Key>::value>::type> {
+    using Bits = typename std::conditional<sizeof(Key) == sizeof(uint32_t), uint32_t, uint64_t>::type;
+    static_assert(sizeof(Key) == sizeof(Bits), "radix sort supports float and double keys");
+
+    static Bits map(Key key) noexcept {
+        Bits bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        const Bits sign = Bits(1) << (8 * sizeof(Bits) - 1);
+        return (bits & sign) ? ~bits : bits | sign;
+    }
+};
+
+template <class Key, class = void>
+struct IsRadixKey : std::false_type {};
+
+template <class Key>
+struct IsRadixKey<Key, decltype(void(RadixKey<Key>::map(Key())))> : std::true_type {};
+
+
+// Raw storage for a sort's scratch copy of the elements. The algorithms
+// construct and destroy the elements themselves.
+template <class T, class Alloc>
+class SortBuffer {
+public:
+    SortBuffer(const Alloc& alloc, size_t count) :
+        alloc_(alloc),
+        count_(count),
+        data_(count == 0 ? nullptr : traits::allocate(alloc_, count)) {}
+    ~SortBuffer() {
+        if (data_ != nullptr) {
+            traits::deallocate(alloc_, data_, count_);
+        }
+    }
+
+    SortBuffer(const SortBuffer&) = delete;
+    SortBuffer& operator=(const SortBuffer&) = delete;
+
+    T* data() noexcept {
+        return data_;
+    }
+    Alloc& allocator() noexcept {
+        return alloc_;
+    }
+
+private:
+    using traits = std::allocator_traits<Alloc>;
+
+    Alloc alloc_;
+    size_t count_;
+    T* data_;
+};
+
+
+template <class T, class Alloc, class KeyFunction>
+void radix_sort(Vector<T, Alloc>& values, KeyFunction key) {
+    using Key = typename std::decay<decltype(key(std::declval<const T&>()))>::type;
+    using Bits = typename RadixKey<Key>::Bits;
+    using traits = std::allocator_traits<Alloc>;
+    static_assert(IsRadixKey<Key>::value, "radix sort needs integral or floating keys");
+    static_assert(std::is_nothrow_move_constructible<T>::value, "radix sort moves elements between buffers");
+
+    const size_t size = values.size();
+    const size_t digits = sizeof(Bits);
+    if (size < 2) {
+        return;
+    }
+
+    using KeyAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Bits>;
+    const bool cache_keys = !noexcept(key(std::declval<const T&>()));
+    SortBuffer<Bits, KeyAlloc> key_buffer(KeyAlloc(values.get_allocator()), cache_keys ? 2 * size : 0);
+    Bits* source_keys = key_buffer.data();
+    Bits* destination_keys = cache_keys ? source_keys + size : nullptr;
+
+    // One pass counts all digits; a digit shared by every key needs no pass.
+    size_t counts[digits][256] = {};
+    for (size_t i = 0; i < size; ++i) {
+        Bits bits = RadixKey<Key>::map(key(values[i]));
+        if (cache_keys) {
+            source_keys[i] = bits;
+        }
+        for (size_t digit = 0; digit < digits; ++digit) {
+            ++counts[digit][(bits >> (8 * digit)) & 0xff];
+        }
+    }
+
+    SortBuffer<T, Alloc> scratch(values.get_allocator(), size);
+    Alloc& alloc = scratch.allocator();
+    T* source = values.data();
+    T* destination = scratch.data();
+    auto bits_of = [&](size_t i) {
+        return cache_keys ? source_keys[i] : RadixKey<Key>::map(key(source[i]));
+    };
+
+    for (size_t digit = 0; digit < digits; ++digit) {
+        const size_t shift = 8 * digit;
+        if (counts[digit][(bits_of(0) >> shift) & 0xff] == size) {
+            continue;
+        }
+
+        size_t offsets[256];
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < 256; ++bucket) {
+            offsets[bucket] = offset;
+            offset += counts[digit][bucket];
+        }
+        for (size_t i = 0; i < size; ++i) {
+            const Bits bits = bits_of(i);
+            const size_t position = offsets[(bits >> shift) & 0xff]++;
+            if (cache_keys) {
+                destination_keys[position] = bits;
+            }
+            traits::construct(alloc, destination + position, std::move(source[i]));
+            traits::destroy(alloc, source + i);
+        }
+        std::swap(source, destination);
+        std::swap(source_keys, destination_keys);
+    }
+
+    if (source != values.data()) {
+        for (size_t i = 0; i < size; ++i) {
+            traits::construct(alloc, destination + i, std::move(source[i]));
+            traits::destroy(alloc, source + i);
+        }
+    }
+}
+
+template <class T, class Alloc>
+void radix_sort(Vector<T, Alloc>& values) {
+    sorting::radix_sort(values, [](const T& value) noexcept { return value; });
+}
+
+
+// Runs task(0) ... task(tasks - 1) on up to threads threads, the calling one included.
+// The first exception thrown by a task is rethrown once all threads are joined.
+template <class Task>
+void parallel_for(size_t tasks, size_t threads, Task task) {
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&](size_t first) {
+        try {
+            for (size_t i = first; i < tasks; i += threads) {
+                task(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    threads = std::min(tasks, threads);
+    std::unique_ptr<std::thread[]> workers(new std::thread[threads > 0 ? threads - 1 : 0]);
+    for (size_t i = 1; i < threads; ++i) {
+        workers[i - 1] = std::thread(worker, i);
+    }
+    worker(0);
+    for (size_t i = 1; i < threads; ++i) {
+        workers[i - 1].join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Number of elements of a taken by the first diagonal elements of their stable merge.
+template <class T, class Compare>
+size_t merge_path(const T* a, size_t a_size, const T* b, size_t b_size, size_t diagonal, Compare& comp) {
+    size_t low = diagonal > b_size ? diagonal - b_size : 0;
+    size_t high = diagonal < a_size ? diagonal : a_size;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (comp(b[diagonal - middle - 1], a[middle])) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+template <class T, class Alloc, class Compare>
+void parallel_merge_sort(Vector<T, Alloc>& values, Compare comp, bool stable, size_t threads) {
+    using traits = std::allocator_traits<Alloc>;
+    const size_t size = values.size();
+    T* data = values.data();
+
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    const size_t min_chunk = 1 << 14;
+    const bool nothrow_moves = std::is_nothrow_move_constructible<T>::value &&
+                               std::is_nothrow_move_assignable<T>::value;
+    if (threads == 1 || size < 2 * min_chunk || !nothrow_moves) {
+        if (stable) {
+            std::stable_sort(data, data + size, comp);
+        } else {
+            std::sort(data, data + size, comp);
+        }
+        return;
+    }
+
+    size_t chunks = 1;
+    while (chunks < threads && size / (2 * chunks) >= min_chunk) {
+        chunks *= 2;
+    }
+    auto bound = [&](size_t chunk) {
+        return size / chunks * chunk + std::min(chunk, size % chunks);
+    };
+
+    // Chunks are sorted in place and moved to the scratch buffer, so merges only assign.
+    SortBuffer<T, Alloc> scratch(values.get_allocator(), size);
+    Alloc& alloc = scratch.allocator();
+    size_t constructed = 0;
+    struct Destroyer {
+        ~Destroyer() {
+            for (size_t i = 0; i < count; ++i) {
+                traits::destroy(alloc, data + i);
+            }
+        }
+        Alloc& alloc;
+        T* data;
+        size_t& count;
+    } destroyer{alloc, scratch.data(), constructed};
+
+    parallel_for(chunks, threads, [&](size_t chunk) {
+        T* first = data + bound(chunk);
+        T* last = data + bound(chunk + 1);
+        if (stable) {
+            std::stable_sort(first, last, comp);
+        } else {
+            std::sort(first, last, comp);
+        }
+    });
+    parallel_for(chunks, threads, [&](size_t chunk) {
+        T* target = scratch.data() + bound(chunk);
+        for (T* element = data + bound(chunk); element != data + bound(chunk + 1); ++element, ++target) {
+            traits::construct(alloc, target, std::move(*element));
+        }
+    });
+    constructed = size;
+
+    T* source = scratch.data();
+    T* destination = data;
+    for (size_t width = 1; width < chunks; width *= 2) {
+        const size_t merges = chunks / (2 * width);
+        const size_t pieces = std::max<size_t>(1, threads / merges);
+
+        parallel_for(merges * pieces, threads, [&](size_t task) {
+            const size_t merge = task / pieces, piece = task % pieces;
+            const size_t first = bound(2 * width * merge);
+            const size_t middle = bound(2 * width * merge + width);
+            const size_t last = bound(2 * width * (merge + 1));
+
+            const T* a = source + first;
+            const T* b = source + middle;
+            const size_t a_size = middle - first, b_size = last - middle;
+            const size_t low = (a_size + b_size) / pieces * piece;
+            const size_t high = piece + 1 == pieces ? a_size + b_size : (a_size + b_size) / pieces * (piece + 1);
+            const size_t a_low = merge_path(a, a_size, b, b_size, low, comp);
+            const size_t a_high = merge_path(a, a_size, b, b_size, high, comp);
+
+            std::merge(std::make_move_iterator(source + first + a_low),
+                       std::make_move_iterator(source + first + a_high),
+                       std::make_move_iterator(source + middle + (low - a_low)),
+                       std::make_move_iterator(source + middle + (high - a_high)),
+                       destination + first + low, comp);
+        });
+        std::swap(source, destination);
+    }
+
+    if (source != data) {
+        parallel_for(chunks, threads, [&](size_t chunk) {
+            std::move(source + bound(chunk), source + bound(chunk + 1), data + bound(chunk));
+        });
+    }
+}
+
+
+template <class T, class Alloc>
+typename std::enable_if<IsRadixKey<T>::value>::type sort(Vector<T, Alloc>& values) {
+    sorting::radix_sort(values);
+}
+
+template <class T, class Alloc>
+typename std::enable_if<!IsRadixKey<T>::value>::type sort(Vector<T, Alloc>& values) {
+    sorting::parallel_merge_sort(values, std::less<T>(), false, 0);
+}
+
+template <class T, class Alloc, class Compare>
+void sort(Vector<T, Alloc>& values, Compare comp, size_t threads = 0) {
+    sorting::parallel_merge_sort(values, comp, false, threads);
+}
+
+template <class T, class Alloc, class Compare = std::less<T>>
+void stable_sort(Vector<T, Alloc>& values, Compare comp = Compare(), size_t threads = 0) {
+    sorting::parallel_merge_sort(values, comp, true, threads);
+}
+
+} // namespace sorting
+
+
+#endif //VECTOR_SORT_H